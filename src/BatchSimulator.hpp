@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "Move.hpp"
+#include "VersusGame.hpp"
+#include "engine/Placement.hpp"
+#include "engine/Utility.hpp"
+#include "util/hash.hpp"
+#include "util/randomizer.hpp"
+#include "util/rng.hpp"
+#include "util/threadpool.hpp"
+
+// totals over a batch of self play games
+struct SelfPlayStats {
+    std::size_t games = 0;
+    // games that ended before the turn limit, the rest count as neither a win nor a draw
+    std::size_t finished = 0;
+    std::size_t p1_wins = 0;
+    std::size_t p2_wins = 0;
+    std::size_t draws = 0;
+
+    // every player placing a piece counts once
+    u64 pieces = 0;
+    double p1_attack = 0;
+    double p2_attack = 0;
+
+    u64 total_turns = 0;
+    int min_turns = 0;
+    int max_turns = 0;
+
+    // attack per piece
+    double app(int id) const {
+        const double placed = pieces / 2.0;
+        return placed == 0 ? 0 : (id == 0 ? p1_attack : p2_attack) / placed;
+    }
+
+    // of the finished games, draws count as half
+    double winrate(int id) const {
+        if (finished == 0)
+            return 0;
+        return ((id == 0 ? p1_wins : p2_wins) + draws * 0.5) / finished;
+    }
+
+    double mean_turns() const {
+        return games == 0 ? 0 : double(total_turns) / games;
+    }
+};
+
+// picks uniformly among every placement, the baseline to measure bots against
+struct RandomPolicy {
+    template <randomizer Randomizer>
+    Move operator()(const BasicVersusGame<Randomizer>& game, int id, RNG& rng) const {
+        std::array<Placement, 1> sampled;
+        if (game.sample_moves(id, rng, sampled) == 0)
+            return Move();
+        return Move(sampled[0].to_piece(), false);
+    }
+};
+
+// a random rotation and column then straight down, costs next to nothing so it measures the simulator itself
+struct DropPolicy {
+    template <randomizer Randomizer>
+    Move operator()(const BasicVersusGame<Randomizer>& game, int id, RNG& rng) const {
+        const Game& player = game.get_game(id);
+        Piece piece = player.current_piece;
+        if (piece.type == PieceType::Empty || Shaktris::Utility::collides(player.board, piece))
+            return Move();
+
+        for (u32 turns = rng.getRand(RotationDirections_N); turns > 0; --turns)
+            player.process_movement(piece, Movement::RotateClockwise);
+
+        const int offset = (int)rng.getRand(Board::width) - (int)Board::width / 2;
+        for (int i = 0; i < std::abs(offset); ++i)
+            player.process_movement(piece, offset < 0 ? Movement::Left : Movement::Right);
+
+        player.process_movement(piece, Movement::SonicDrop);
+        return Move(piece, false);
+    }
+};
+
+// lots of independent VersusGames stepped a turn at a time across a thread pool
+// the games sit next to each other in one array and every game only ever reads its own seeds,
+// so the result is the same as playing them one after another, whatever the thread count
+template <randomizer Randomizer = RNG>
+class BatchSimulator {
+   public:
+    // game i is seeded from seed and i, both players of a game get the same pieces
+    BatchSimulator(ThreadPool& pool, std::size_t count, u64 seed) : pool(pool) {
+        games.reserve(count);
+        policy_rngs.reserve(count);
+        outcomes.assign(count, Outcomes::NONE);
+        for (std::size_t i = 0; i < count; ++i) {
+            const u64 game_seed = hash_mix(seed + i);
+            games.emplace_back(static_cast<u32>(game_seed));
+            policy_rngs.emplace_back(static_cast<u32>(game_seed >> 32));
+        }
+    }
+
+    std::size_t size() const {
+        return games.size();
+    }
+
+    // the same turn one game of the batch gets, also what sequential play runs
+    // policy(game, id, rng) returns the move of player id, a null move means that player has no placement and loses
+    template <class Policy>
+    static bool step(BasicVersusGame<Randomizer>& game, Outcomes& outcome, Policy& policy, RNG& rng) {
+        if (game.game_over)
+            return false;
+
+        const Move p1 = policy(game, 0, rng);
+        const Move p2 = policy(game, 1, rng);
+        if (p1.null_move || p2.null_move) {
+            game.game_over = true;
+            outcome = p1.null_move && p2.null_move ? Outcomes::DRAW : (p1.null_move ? Outcomes::P2_WIN : Outcomes::P1_WIN);
+            return false;
+        }
+
+        game.set_move(0, p1);
+        game.set_move(1, p2);
+        game.play_moves();
+
+        if (game.game_over) {
+            outcome = game.get_winner();
+            return false;
+        }
+        return true;
+    }
+
+    // one turn of every running game in lockstep, policy has to be safe to call from several threads
+    // returns how many games are still running
+    template <class Policy>
+    std::size_t step(Policy& policy) {
+        const std::size_t grain = std::max<std::size_t>(1, games.size() / (pool.size() * 8));
+        parallel_for(pool, 0, games.size(), grain, [&](std::size_t i) {
+            step(games[i], outcomes[i], policy, policy_rngs[i]);
+        });
+
+        return static_cast<std::size_t>(std::ranges::count_if(games, [](const auto& game) { return !game.game_over; }));
+    }
+
+    // steps until every game is over or max_turns turns were played
+    template <class Policy>
+    SelfPlayStats run(Policy& policy, int max_turns) {
+        for (int turn = 0; turn < max_turns; ++turn) {
+            if (step(policy) == 0)
+                break;
+        }
+        return stats();
+    }
+
+    SelfPlayStats stats() const {
+        return stats(games, outcomes);
+    }
+
+    static SelfPlayStats stats(std::span<const BasicVersusGame<Randomizer>> games, std::span<const Outcomes> outcomes) {
+        SelfPlayStats ret;
+        ret.games = games.size();
+        ret.min_turns = games.empty() ? 0 : std::numeric_limits<int>::max();
+
+        for (std::size_t i = 0; i < games.size(); ++i) {
+            const auto& game = games[i];
+            ret.pieces += u64(game.turn) * 2;
+            ret.p1_attack += game.p1_atk;
+            ret.p2_attack += game.p2_atk;
+            ret.total_turns += game.turn;
+            ret.min_turns = std::min(ret.min_turns, game.turn);
+            ret.max_turns = std::max(ret.max_turns, game.turn);
+
+            switch (outcomes[i]) {
+                case Outcomes::P1_WIN:
+                    ret.p1_wins++;
+                    break;
+                case Outcomes::P2_WIN:
+                    ret.p2_wins++;
+                    break;
+                case Outcomes::DRAW:
+                    ret.draws++;
+                    break;
+                case Outcomes::NONE:
+                    continue;
+            }
+            ret.finished++;
+        }
+        return ret;
+    }
+
+    ThreadPool& pool;
+
+    std::vector<BasicVersusGame<Randomizer>> games;
+    // what each game's policy draws from, kept per game so the thread running it does not matter
+    std::vector<RNG> policy_rngs;
+    std::vector<Outcomes> outcomes;
+};
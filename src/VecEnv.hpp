@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "Move.hpp"
+#include "VersusGame.hpp"
+#include "engine/ActionMask.hpp"
+#include "engine/Board.hpp"
+#include "engine/Placement.hpp"
+#include "engine/Reachability.hpp"
+#include "util/hash.hpp"
+#include "util/randomizer.hpp"
+#include "util/threadpool.hpp"
+
+// N VersusGames behind one step call, for training agents on self play
+// every env has two agents, agent 2 * env + id plays player id, and everything is written into caller owned buffers
+// so after construction a step never allocates
+template <randomizer Randomizer = RNG>
+class VecEnv {
+   public:
+    static constexpr std::size_t players = 2;
+    static constexpr std::size_t piece_types = static_cast<std::size_t>(PieceType::Empty);
+    static constexpr std::size_t board_cells = Board::width * Board::height;
+
+    // observation of one agent, all floats
+    // boards are column major, cell x * Board::height + y is 1 if it is filled
+    // pieces are one hot over the seven types, all zero for no piece
+    static constexpr std::size_t own_board_offset = 0;
+    static constexpr std::size_t opponent_board_offset = own_board_offset + board_cells;
+    static constexpr std::size_t current_offset = opponent_board_offset + board_cells;
+    static constexpr std::size_t hold_offset = current_offset + piece_types;
+    static constexpr std::size_t queue_offset = hold_offset + piece_types;
+    // b2b, combo, garbage waiting for this player, garbage waiting for the opponent
+    static constexpr std::size_t counters_offset = queue_offset + piece_types * QUEUE_SIZE;
+    static constexpr std::size_t obs_size = counters_offset + 4;
+
+    // pool is optional, without one the envs are stepped on the calling thread
+    VecEnv(std::size_t count, u64 seed, ThreadPool* pool = nullptr)
+        : seed(seed), pool(pool), episodes(count, 0), masks(count * players), masks_fresh(count, 0) {
+        games.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+            games.emplace_back(episode_seed(i));
+    }
+
+    std::size_t size() const {
+        return games.size();
+    }
+
+    std::size_t agents() const {
+        return games.size() * players;
+    }
+
+    // starts a fresh episode in every env, obs holds agents() * obs_size floats
+    void reset(std::span<float> obs) {
+        for_each_env([&](std::size_t i) {
+            reset(i);
+            write_observations(i, obs);
+        });
+    }
+
+    // plays one placement per agent, actions[2 * env + id] is the move of player id and has to be one of its placements
+    // (current piece or the piece hold gives, reachable from spawn the way god_movegen reaches it), anything else loses the game for that player
+    // the spin of the action is ignored, the one played is what the board gives, so a policy can not claim a spin it did not do
+    // rewards get attack_reward per line of attack sent plus win_reward or -win_reward when the game ends
+    // an env that is done restarts right away, obs then holds the first observation of its next episode
+    void step(std::span<const Placement> actions, std::span<float> obs, std::span<float> rewards, std::span<u8> dones) {
+        for_each_env([&](std::size_t i) {
+            std::array<std::optional<Placement>, players> placements;
+            for (std::size_t id = 0; id < players; ++id)
+                placements[id] = legal(games[i].get_game((int)id), actions[i * players + id]);
+
+            dones[i] = step(i, placements, rewards.subspan(i * players, players));
+            if (dones[i])
+                reset(i);
+            write_observations(i, obs);
+        });
+    }
+
+    // same step with Shaktris::ActionMask indices instead of placements, spins come from movegen
+    // the masks are kept from write_masks when it was called since the last step, so they are only built once
+    void step_actions(std::span<const u32> actions, std::span<float> obs, std::span<float> rewards, std::span<u8> dones) {
+        for_each_env([&](std::size_t i) {
+            const std::span<const Shaktris::ActionMask::Masks> agent = agent_masks(i);
+            std::array<std::optional<Placement>, players> placements;
+            for (std::size_t id = 0; id < players; ++id) {
+                const u32 action = actions[i * players + id];
+                if (action < Shaktris::ActionMask::size && agent[id].legal(action))
+                    placements[id] = agent[id].placement(action);
+            }
+
+            dones[i] = step(i, placements, rewards.subspan(i * players, players));
+            if (dones[i])
+                reset(i);
+            write_observations(i, obs);
+        });
+    }
+
+    // the legal placements of every agent as Shaktris::ActionMask bits, agents() * ActionMask::words words
+    // an action index maps back to its placement with ActionMask::Masks::placement
+    void write_masks(std::span<u64> out) {
+        for_each_env([&](std::size_t i) {
+            const std::span<const Shaktris::ActionMask::Masks> agent = agent_masks(i);
+            for (std::size_t id = 0; id < players; ++id)
+                agent[id].write(out.subspan((i * players + id) * Shaktris::ActionMask::words).template first<Shaktris::ActionMask::words>());
+        });
+    }
+
+    // the action with the spin the board gives it, nothing if it is not one of the placements of game
+    static std::optional<Placement> legal(const Game& game, Placement action) {
+        const PieceType type = action.type();
+        const PieceType hold_type = game.hold.has_value() ? game.hold.value() : game.queue.front();
+        if (game.current_piece.type == PieceType::Empty || type >= PieceType::Empty || (type != game.current_piece.type && type != hold_type))
+            return std::nullopt;
+
+        const std::optional<spinType> spin = game.visit_kicks_180(
+            [&]<const KickTable180* Kicks180>() { return Shaktris::MoveGen::Reachability::reachable_spin<Kicks180>(game.board, action); });
+        if (!spin)
+            return std::nullopt;
+        return Placement(type, action.rotation(), action.position(), *spin);
+    }
+
+    static void write_observation(const BasicVersusGame<Randomizer>& game, int id, std::span<float, obs_size> out) {
+        const Game& self = game.get_game(id);
+        const Game& opponent = game.get_game(1 - id);
+
+        write_board(self.board, out.data() + own_board_offset);
+        write_board(opponent.board, out.data() + opponent_board_offset);
+
+        write_piece(self.current_piece.type, out.data() + current_offset);
+        write_piece(self.hold.has_value() ? self.hold.value() : PieceType::Empty, out.data() + hold_offset);
+        for (std::size_t i = 0; i < QUEUE_SIZE; ++i)
+            write_piece(self.queue[i], out.data() + queue_offset + piece_types * i);
+
+        out[counters_offset + 0] = self.b2b;
+        out[counters_offset + 1] = self.combo;
+        out[counters_offset + 2] = static_cast<float>(id == 0 ? game.p1_meter : game.p2_meter);
+        out[counters_offset + 3] = static_cast<float>(id == 0 ? game.p2_meter : game.p1_meter);
+    }
+
+    float attack_reward = 1.0f;
+    float win_reward = 1.0f;
+    // episodes longer than this are cut off, done without a winner
+    int max_turns = 1000;
+
+    u64 seed;
+    ThreadPool* pool;
+
+    std::vector<BasicVersusGame<Randomizer>> games;
+    // how many episodes each env has started, part of the seed of the next one
+    std::vector<u32> episodes;
+    // both agents' masks of every env, valid while masks_fresh is set
+    std::vector<Shaktris::ActionMask::Masks> masks;
+    std::vector<u8> masks_fresh;
+
+   private:
+    template <class F>
+    void for_each_env(const F& f) {
+        if (pool) {
+            const std::size_t grain = std::max<std::size_t>(1, games.size() / (pool->size() * 8));
+            parallel_for(*pool, 0, games.size(), grain, f);
+        }
+        else {
+            for (std::size_t i = 0; i < games.size(); ++i)
+                f(i);
+        }
+    }
+
+    u32 episode_seed(std::size_t i) const {
+        return static_cast<u32>(hash_combine(seed + i, episodes[i]));
+    }
+
+    std::span<const Shaktris::ActionMask::Masks> agent_masks(std::size_t i) {
+        const std::span<Shaktris::ActionMask::Masks> agent = std::span(masks).subspan(i * players, players);
+        if (!masks_fresh[i]) {
+            for (std::size_t id = 0; id < players; ++id)
+                agent[id] = Shaktris::ActionMask::masks(games[i].get_game((int)id));
+            masks_fresh[i] = 1;
+        }
+        return agent;
+    }
+
+    void reset(std::size_t i) {
+        masks_fresh[i] = 0;
+        episodes[i]++;
+        games[i] = BasicVersusGame<Randomizer>(episode_seed(i));
+    }
+
+    // actions are already checked, nothing for a player whose action was not legal
+    // returns whether the episode ended
+    bool step(std::size_t i, std::span<const std::optional<Placement>, players> actions, std::span<float> rewards) {
+        BasicVersusGame<Randomizer>& game = games[i];
+        masks_fresh[i] = 0;
+        const bool p1_legal = actions[0].has_value();
+        const bool p2_legal = actions[1].has_value();
+
+        Outcomes outcome = Outcomes::NONE;
+        const double p1_atk = game.p1_atk;
+        const double p2_atk = game.p2_atk;
+
+        if (!p1_legal || !p2_legal) {
+            game.game_over = true;
+            outcome = !p1_legal && !p2_legal ? Outcomes::DRAW : (p1_legal ? Outcomes::P1_WIN : Outcomes::P2_WIN);
+        }
+        else {
+            game.set_move(0, Move(actions[0]->to_piece(), false));
+            game.set_move(1, Move(actions[1]->to_piece(), false));
+            game.play_moves();
+            if (game.game_over)
+                outcome = game.get_winner();
+        }
+
+        rewards[0] = static_cast<float>(game.p1_atk - p1_atk) * attack_reward;
+        rewards[1] = static_cast<float>(game.p2_atk - p2_atk) * attack_reward;
+        if (outcome == Outcomes::P1_WIN) {
+            rewards[0] += win_reward;
+            rewards[1] -= win_reward;
+        }
+        else if (outcome == Outcomes::P2_WIN) {
+            rewards[0] -= win_reward;
+            rewards[1] += win_reward;
+        }
+
+        return game.game_over || game.turn >= max_turns;
+    }
+
+    void write_observations(std::size_t i, std::span<float> obs) {
+        for (std::size_t id = 0; id < players; ++id)
+            write_observation(games[i], (int)id, obs.subspan((i * players + id) * obs_size).template first<obs_size>());
+    }
+
+    // one column at a time, the inner loop is a plain bit test per row so it vectorizes
+    static void write_board(const Board& board, float* __restrict out) {
+        for (std::size_t x = 0; x < Board::width; ++x) {
+            const column_t column = board.board[x];
+            for (std::size_t y = 0; y < Board::height; ++y)
+                out[x * Board::height + y] = static_cast<float>((column >> y) & 1);
+        }
+    }
+
+    static void write_piece(PieceType type, float* __restrict out) {
+        for (std::size_t i = 0; i < piece_types; ++i)
+            out[i] = static_cast<float>(static_cast<std::size_t>(type) == i);
+    }
+};
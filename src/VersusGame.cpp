@@ -1,13 +1,38 @@
 #include "VersusGame.hpp"
 
 #include <algorithm>
-#include <set>
+#include <array>
 
 #include "Move.hpp"
 #include "util/rng.hpp"
 #include "engine/MoveGen.hpp"
+#include "engine/MoveSampling.hpp"
+#include "replay/Replay.hpp"
 
-void VersusGame::play_moves() {
+template <randomizer Randomizer>
+void BasicVersusGame<Randomizer>::deal() {
+    p1_game.deal(p1_rng);
+    p2_game.deal(p2_rng);
+}
+
+template <randomizer Randomizer>
+int BasicVersusGame<Randomizer>::play_move(Game& game, const Move& move, double& atk, int& opponent_meter, bool& first_hold) {
+    if (move.null_move)
+        return 0;
+
+    first_hold = game.place_piece(move.piece);
+    const int cleared_lines = game.board.clearLines();
+
+    const int dmg = game.damage_sent(cleared_lines, move.piece.spin, game.board.is_empty());
+
+    atk += dmg;
+    opponent_meter += dmg;
+
+    return cleared_lines;
+}
+
+template <randomizer Randomizer>
+void BasicVersusGame<Randomizer>::play_moves() {
     // game over conditions
 
     if (game_over) {
@@ -21,69 +46,10 @@ void VersusGame::play_moves() {
 
     turn += 1;
 
-    int p1_cleared_lines = 0;
     bool p1_first_hold = false;
-    // player 1 move
-    if (!p1_move.null_move) {
-        spinType spin = p1_move.piece.spin;
-
-        p1_first_hold = p1_game.place_piece(p1_move.piece);
-        p1_cleared_lines = p1_game.board.clearLines();
-
-        bool pc = true;
-        for (size_t i = 0; i < Board::width; i++) {
-            if (p1_game.board.get_column(i) != 0) {
-                pc = false;
-                break;
-            }
-        }
-
-        if (spin == spinType::normal && p1_cleared_lines > 0) {
-            // std::cout << "p1 did T-spin " << p1_cleared_lines << std::endl;
-        }
-
-        if (pc) {
-            // std::cout << "p1 did perfect clear" << std::endl;
-        }
-
-        int dmg = p1_game.damage_sent(p1_cleared_lines, spin, pc);
-
-        p1_atk += dmg;
-
-        p2_meter += dmg;
-    }
-
-    int p2_cleared_lines = 0;
     bool p2_first_hold = false;
-    // player 1 move
-    if (!p2_move.null_move) {
-        spinType spin = p2_move.piece.spin;
-
-        p2_first_hold = p2_game.place_piece(p2_move.piece);
-        p2_cleared_lines = p2_game.board.clearLines();
-
-        bool pc = true;
-        for (size_t i = 0; i < Board::width; i++) {
-            if (p2_game.board.get_column(i) != 0) {
-                pc = false;
-                break;
-            }
-        }
-
-        if (spin == spinType::normal && p2_cleared_lines > 0) {
-            // std::cout << "p2 did T-spin " << p2_cleared_lines << std::endl;
-        }
-
-        if (pc) {
-            // std::cout << "p2 did perfect clear" << std::endl;
-        }
-
-        int dmg = p2_game.damage_sent(p2_cleared_lines, spin, pc);
-
-        p2_atk += dmg;
-
-        p1_meter += dmg;
-    }
+    const int p1_cleared_lines = play_move(p1_game, p1_move, p1_atk, p2_meter, p1_first_hold);
+    const int p2_cleared_lines = play_move(p2_game, p2_move, p2_atk, p1_meter, p2_first_hold);
 
     int min_meter = std::min(p1_meter, p2_meter);
 
@@ -107,14 +73,15 @@ void VersusGame::play_moves() {
         }
     }
 
+    // a first hold took two pieces out of the queue
     if (p1_first_hold)
-        *(p1_game.queue.end() - 2) = p1_rng.getPiece();
+        p1_game.queue.push(p1_rng.getPiece());
 
     if (p2_first_hold)
-        *(p2_game.queue.end() - 2) = p2_rng.getPiece();
+        p2_game.queue.push(p2_rng.getPiece());
 
-    p1_game.queue.back() = p1_rng.getPiece();
-    p2_game.queue.back() = p2_rng.getPiece();
+    p1_game.queue.push(p1_rng.getPiece());
+    p2_game.queue.push(p2_rng.getPiece());
 
     if (Shaktris::Utility::collides(p1_game.board, p1_game.current_piece)) {
         game_over = true;
@@ -123,17 +90,23 @@ void VersusGame::play_moves() {
     if (Shaktris::Utility::collides(p2_game.board, p2_game.current_piece)) {
         game_over = true;
     }
+
+    if (recorder)
+        recorder->record(*this);
 }
 
-VersusGame VersusGame::play_moves_not_inplace() {
-    VersusGame copy = VersusGame(*this);
+template <randomizer Randomizer>
+BasicVersusGame<Randomizer> BasicVersusGame<Randomizer>::play_moves_not_inplace() {
+    BasicVersusGame copy = BasicVersusGame(*this);
+    copy.recorder = nullptr;
 
     copy.play_moves();
 
     return copy;
 }
 
-std::vector<Move> VersusGame::get_moves(int id) const {
+template <randomizer Randomizer>
+std::vector<Move> BasicVersusGame<Randomizer>::get_moves(int id) const {
     std::vector<Move> moves;
 
     const Game& player = id == 0 ? p1_game : p2_game;
@@ -161,53 +134,14 @@ std::vector<Move> VersusGame::get_moves(int id) const {
     return moves;
 }
 
-std::vector<Move> VersusGame::get_N_moves(int id, int N) const {
-    const Game& player = id == 0 ? p1_game : p2_game;
-    std::vector<Piece> valid_pieces = Shaktris::MoveGen::Traditional::movegen(srs_rotate, player.board, player.current_piece.type);
-    PieceType holdType = player.hold.has_value() ? player.hold.value() : player.queue.front();
-
-    std::vector<Piece> hold_pieces = Shaktris::MoveGen::Traditional::movegen(srs_rotate, player.board, holdType);
-    valid_pieces.reserve(valid_pieces.size() + hold_pieces.size());
-    for (auto& piece : hold_pieces) {
-        valid_pieces.emplace_back(piece);
-    }
-
-    std::vector<std::optional<Piece>> moves;
-
-    for (auto& piece : valid_pieces) {
-        Board temp_board = player.board;
-        temp_board.set(piece);
-        moves.emplace_back(piece);
-    }
-
-    // try the null move
-    {
-        // moves.emplace_back(std::nullopt);
-    }
-
-    std::vector<Move> out;
-    out.reserve(N);
-
-    // make sure not to sample the same move twice
-    RNG rng_1;
-
-    std::set<int> sampled_indices;
-
-    for (int i = 0; i < N; i++) {
-        int index = rng_1.getRand(moves.size());
-        while (sampled_indices.find(index) != sampled_indices.end()) {
-            index = rng_1.getRand(moves.size());
-        }
-
-        sampled_indices.insert(index);
-
-        out.emplace_back(moves[static_cast<size_t>(index)]);
-    }
-
-    return out;
+template <randomizer Randomizer>
+std::vector<Move> BasicVersusGame<Randomizer>::get_N_moves(int id, int N) const {
+    RNG rng;
+    return get_N_moves(id, N, rng);
 }
 
-Outcomes VersusGame::get_winner() const {
+template <randomizer Randomizer>
+Outcomes BasicVersusGame<Randomizer>::get_winner() const {
     Outcomes out = Outcomes::NONE;
 
     if (Shaktris::Utility::collides(p1_game.board, p1_game.current_piece)) {
@@ -225,10 +159,17 @@ Outcomes VersusGame::get_winner() const {
     return out;
 }
 
-void VersusGame::set_move(int id, Move move) {
+template <randomizer Randomizer>
+void BasicVersusGame<Randomizer>::set_move(int id, Move move) {
     if (id == 0) {
         p1_move = move;
     } else {
         p2_move = move;
     }
 }
+
+template class BasicVersusGame<RNG>;
+template class BasicVersusGame<CounterRNG>;
+template class BasicVersusGame<Bag14>;
+template class BasicVersusGame<PureRandom>;
+template class BasicVersusGame<NesReroll>;
@@ -1,13 +1,20 @@
 #pragma once
+#include <algorithm>
+#include <array>
 #include <optional>
+#include <span>
 #include <vector>
 
 #include "engine/Game.hpp"
+#include "engine/MoveSampling.hpp"
 #include "Move.hpp"
 #include "engine/Piece.hpp"
+#include "engine/Placement.hpp"
+#include "util/randomizer.hpp"
 #include "util/rng.hpp"
 
 class Tetris;
+class ReplayWriter;
 
 enum Outcomes {
     P1_WIN,
@@ -16,13 +23,28 @@ enum Outcomes {
     NONE
 };
 
-class VersusGame {
+// a match between two players, Randomizer deals the pieces and picks the garbage columns
+template <randomizer Randomizer = RNG>
+class BasicVersusGame {
    public:
+    // rngs seed themselves from std::random_device and nothing is dealt yet
+    BasicVersusGame() = default;
+
+    // both players get the same pieces, like a TETR.IO match with this seed, and their opening queues are dealt
+    explicit BasicVersusGame(u32 seed) : BasicVersusGame(seed, seed) {}
+
+    BasicVersusGame(u32 p1_seed, u32 p2_seed) : p1_rng(p1_seed), p2_rng(p2_seed) {
+        deal();
+    }
+
+    // fills the current piece and queue of both players from their rngs
+    void deal();
+
     Game p1_game;
     Game p2_game;
 
-    RNG p1_rng;
-    RNG p2_rng;
+    Randomizer p1_rng;
+    Randomizer p2_rng;
 
     Move p1_move = Move(Piece(PieceType::Empty), false);
     Move p2_move = Move(Piece(PieceType::Empty), false);
@@ -36,6 +58,9 @@ class VersusGame {
     int turn = 0;
     bool game_over = false;
 
+    // gets every turn play_moves plays when set, copies made by play_moves_not_inplace do not record
+    ReplayWriter* recorder = nullptr;
+
     // get attack per piece
     double get_app(int id) const {
         return id == 0 ? p1_atk / turn : p2_atk / turn;
@@ -53,12 +78,71 @@ class VersusGame {
 
     void play_moves();
 
-    VersusGame play_moves_not_inplace(void);
+    BasicVersusGame play_moves_not_inplace(void);
 
     std::vector<Move> get_moves(int id) const;
     std::vector<Move> get_N_moves(int id, int N) const;
+    // N distinct moves uniformly at random out of the same Traditional::movegen list get_moves uses, fewer if there are not that many
+    template <Shaktris::MoveGen::Sampling::random_source Rng>
+    std::vector<Move> get_N_moves(int id, int N, Rng& rng) const;
+
+    // N distinct placements uniformly at random straight from the placement bitboards, without allocating
+    // these are god_movegen's placements, not Traditional's: south and west of I, S and Z fold into north and east,
+    // and a spin is any placement that can not move left, right or up
+    // returns how many placements were written to out
+    template <Shaktris::MoveGen::Sampling::random_source Rng>
+    size_t sample_moves(int id, Rng& rng, std::span<Placement> out) const;
 
     Outcomes get_winner() const;
 
     friend class Tetris;
-};
\ No newline at end of file
+
+   private:
+    // places one player's move, adds the attack to atk and the opponent's meter and returns the lines cleared
+    static int play_move(Game& game, const Move& move, double& atk, int& opponent_meter, bool& first_hold);
+};
+
+// the draws take any rng, so they live here rather than with the rest in VersusGame.cpp
+template <randomizer Randomizer>
+template <Shaktris::MoveGen::Sampling::random_source Rng>
+std::vector<Move> BasicVersusGame<Randomizer>::get_N_moves(int id, int N, Rng& rng) const {
+    const Game& player = get_game(id);
+    if (player.current_piece.type == PieceType::Empty)
+        return {};
+
+    std::vector<Piece> valid_pieces = Shaktris::MoveGen::Traditional::movegen(srs_rotate, player.board, player.current_piece.type);
+    const PieceType hold = player.hold.has_value() ? player.hold.value() : player.queue.front();
+    if (hold != PieceType::Empty) {
+        std::vector<Piece> hold_pieces = Shaktris::MoveGen::Traditional::movegen(srs_rotate, player.board, hold);
+        valid_pieces.insert(valid_pieces.end(), hold_pieces.begin(), hold_pieces.end());
+    }
+
+    // partial fisher yates, the first count pieces end up a uniform draw without repeats
+    const size_t count = std::min<size_t>(std::max(N, 0), valid_pieces.size());
+    std::vector<Move> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::swap(valid_pieces[i], valid_pieces[i + rng.getRand((u32)(valid_pieces.size() - i))]);
+        out.emplace_back(valid_pieces[i], false);
+    }
+
+    return out;
+}
+
+template <randomizer Randomizer>
+template <Shaktris::MoveGen::Sampling::random_source Rng>
+size_t BasicVersusGame<Randomizer>::sample_moves(int id, Rng& rng, std::span<Placement> out) const {
+    std::array<Shaktris::MoveGen::Sampling::PlacementSet, 2> sets;
+    const size_t used = Shaktris::MoveGen::Sampling::placement_sets(get_game(id), sets);
+
+    return Shaktris::MoveGen::Sampling::sample_distinct(std::span(sets).first(used), rng, out);
+}
+
+using VersusGame = BasicVersusGame<RNG>;
+
+// every randomizer is compiled once in VersusGame.cpp
+extern template class BasicVersusGame<RNG>;
+extern template class BasicVersusGame<CounterRNG>;
+extern template class BasicVersusGame<Bag14>;
+extern template class BasicVersusGame<PureRandom>;
+extern template class BasicVersusGame<NesReroll>;
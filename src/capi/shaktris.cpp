@@ -0,0 +1,262 @@
+#define SHAKTRIS_BUILDING_C_API
+#include "shaktris.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "VecEnv.hpp"
+#include "engine/ActionMask.hpp"
+#include "engine/Board.hpp"
+#include "engine/Game.hpp"
+#include "engine/MoveSampling.hpp"
+#include "engine/Placement.hpp"
+#include "engine/Reachability.hpp"
+#include "search/Eval.hpp"
+#include "util/threadpool.hpp"
+
+static_assert(SHAKTRIS_BOARD_WIDTH == Board::width && SHAKTRIS_BOARD_HEIGHT == Board::height, "board size does not match the header");
+static_assert(SHAKTRIS_PIECE_NONE == static_cast<int>(PieceType::Empty), "piece types do not match the header");
+static_assert(SHAKTRIS_ACTIONS == Shaktris::ActionMask::size && SHAKTRIS_MASK_WORDS == Shaktris::ActionMask::words, "action space does not match the header");
+static_assert(Placement::type_shift == 0 && Placement::rotation_shift == 3 && Placement::x_shift == 5 && Placement::y_shift == 9 && Placement::spin_shift == 14,
+    "placement layout does not match the header");
+static_assert(Placement::from_raw(SHAKTRIS_NO_PLACEMENT).type() == PieceType::Empty, "no placement has to decode as no piece");
+
+struct shaktris_context {
+    explicit shaktris_context(uint32_t threads) : pool(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    ThreadPool pool;
+};
+
+struct shaktris_env {
+    shaktris_env(shaktris_context* context, size_t n, uint64_t seed) : env(n, seed, context ? &context->pool : nullptr) {}
+
+    VecEnv<RNG> env;
+};
+
+namespace {
+
+    constexpr bool valid_piece(uint8_t type) {
+        return type <= SHAKTRIS_PIECE_NONE;
+    }
+
+    Board load_board(const uint32_t* boards, size_t i) {
+        Board board;
+        std::memcpy(board.board.data(), boards + i * Board::width, sizeof(column_t) * Board::width);
+        return board;
+    }
+
+    // every exception stops here, nothing unwinds into the caller's language
+    // that covers the worker threads too, parallel_for rethrows what its tasks threw on the thread that called it
+    template <class F>
+    shaktris_status guarded(F&& f) {
+        try {
+            return f();
+        }
+        catch (const std::bad_alloc&) {
+            return SHAKTRIS_OUT_OF_MEMORY;
+        }
+        catch (...) {
+            return SHAKTRIS_INTERNAL_ERROR;
+        }
+    }
+
+    // runs f(i) for every position, across the context's threads when there is one
+    template <class F>
+    void for_each(shaktris_context* context, size_t n, const F& f) {
+        if (context) {
+            const size_t grain = std::max<size_t>(1, n / (context->pool.size() * 8));
+            parallel_for(context->pool, 0, n, grain, f);
+        }
+        else {
+            for (size_t i = 0; i < n; ++i)
+                f(i);
+        }
+    }
+
+};
+
+extern "C" {
+
+uint32_t shaktris_abi_version(void) {
+    return SHAKTRIS_ABI_VERSION;
+}
+
+shaktris_context* shaktris_context_create(uint32_t threads) {
+    try {
+        return new shaktris_context(threads);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void shaktris_context_destroy(shaktris_context* context) {
+    delete context;
+}
+
+shaktris_status shaktris_movegen(shaktris_context* context, const uint32_t* boards, const uint8_t* types, size_t n,
+    uint16_t* out, size_t stride, uint32_t* counts) {
+    if (n == 0)
+        return SHAKTRIS_OK;
+    if (!boards || !types || !counts || (stride && !out))
+        return SHAKTRIS_INVALID_ARGUMENT;
+    if (!std::all_of(types, types + n, valid_piece))
+        return SHAKTRIS_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        for_each(context, n, [&](size_t i) {
+            uint16_t* written = out + i * stride;
+            uint32_t count = 0;
+            const PieceType type = static_cast<PieceType>(types[i]);
+            if (type != PieceType::Empty) {
+                Shaktris::MoveGen::Smeared::god_movegen(load_board(boards, i), type, [&](Placement placement) {
+                    if (count < stride)
+                        written[count] = placement.raw();
+                    count++;
+                });
+            }
+            counts[i] = count;
+        });
+        return SHAKTRIS_OK;
+    });
+}
+
+shaktris_status shaktris_is_legal(shaktris_context* context, const uint32_t* boards, const uint16_t* placements, size_t n,
+    uint8_t* out) {
+    if (n == 0)
+        return SHAKTRIS_OK;
+    if (!boards || !placements || !out)
+        return SHAKTRIS_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        for_each(context, n, [&](size_t i) {
+            out[i] = Shaktris::MoveGen::Reachability::is_legal(load_board(boards, i), Placement::from_raw(placements[i]));
+        });
+        return SHAKTRIS_OK;
+    });
+}
+
+shaktris_status shaktris_action_masks(shaktris_context* context, const uint32_t* boards, const uint8_t* current,
+    const uint8_t* hold, const uint8_t* queue_front, size_t n, uint64_t* out) {
+    if (n == 0)
+        return SHAKTRIS_OK;
+    if (!boards || !current || !hold || !queue_front || !out)
+        return SHAKTRIS_INVALID_ARGUMENT;
+    if (!std::all_of(current, current + n, valid_piece) || !std::all_of(hold, hold + n, valid_piece) ||
+        !std::all_of(queue_front, queue_front + n, valid_piece))
+        return SHAKTRIS_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        for_each(context, n, [&](size_t i) {
+            Game game;
+            game.board = load_board(boards, i);
+            game.current_piece = static_cast<PieceType>(current[i]);
+            if (hold[i] != SHAKTRIS_PIECE_NONE)
+                game.hold = static_cast<PieceType>(hold[i]);
+            game.queue.set(0, static_cast<PieceType>(queue_front[i]));
+
+            Shaktris::ActionMask::masks(game).write(std::span<u64, Shaktris::ActionMask::words>(out + i * Shaktris::ActionMask::words, Shaktris::ActionMask::words));
+        });
+        return SHAKTRIS_OK;
+    });
+}
+
+uint16_t shaktris_action_placement(uint32_t action, uint8_t current, uint8_t hold_piece) {
+    using namespace Shaktris::ActionMask;
+    if (action >= size || !valid_piece(current) || !valid_piece(hold_piece))
+        return SHAKTRIS_NO_PLACEMENT;
+
+    const uint8_t type = uses_hold(action) ? hold_piece : current;
+    if (type == SHAKTRIS_PIECE_NONE)
+        return SHAKTRIS_NO_PLACEMENT;
+    return Placement(static_cast<PieceType>(type), rotation(action), position(action)).raw();
+}
+
+shaktris_status shaktris_evaluate(shaktris_context* context, const uint32_t* boards, size_t n, float* scores) {
+    if (n == 0)
+        return SHAKTRIS_OK;
+    if (!boards || !scores)
+        return SHAKTRIS_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        for_each(context, n, [&](size_t i) {
+            scores[i] = Shaktris::Search::evaluate(load_board(boards, i));
+        });
+        return SHAKTRIS_OK;
+    });
+}
+
+shaktris_env* shaktris_env_create(shaktris_context* context, size_t n, uint64_t seed) {
+    try {
+        return new shaktris_env(context, n, seed);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void shaktris_env_destroy(shaktris_env* env) {
+    delete env;
+}
+
+size_t shaktris_env_size(const shaktris_env* env) {
+    return env ? env->env.size() : 0;
+}
+
+size_t shaktris_env_observation_size(void) {
+    return VecEnv<RNG>::obs_size;
+}
+
+shaktris_status shaktris_env_reset(shaktris_env* env, float* obs) {
+    if (!env || !obs)
+        return SHAKTRIS_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        env->env.reset(std::span(obs, env->env.agents() * VecEnv<RNG>::obs_size));
+        return SHAKTRIS_OK;
+    });
+}
+
+shaktris_status shaktris_env_step(shaktris_env* env, const uint32_t* actions, float* obs, float* rewards, uint8_t* dones) {
+    if (!env || !actions || !obs || !rewards || !dones)
+        return SHAKTRIS_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        const size_t agents = env->env.agents();
+        env->env.step_actions(std::span(actions, agents), std::span(obs, agents * VecEnv<RNG>::obs_size), std::span(rewards, agents),
+            std::span(dones, env->env.size()));
+        return SHAKTRIS_OK;
+    });
+}
+
+shaktris_status shaktris_env_step_placements(shaktris_env* env, const uint16_t* placements, float* obs, float* rewards, uint8_t* dones) {
+    if (!env || !placements || !obs || !rewards || !dones)
+        return SHAKTRIS_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        const size_t agents = env->env.agents();
+        // grows once per calling thread and is reused after that
+        std::vector<Placement>& actions = ThreadPool::scratch<std::vector<Placement>>();
+        actions.resize(agents);
+        for (size_t i = 0; i < agents; ++i)
+            actions[i] = Placement::from_raw(placements[i]);
+        env->env.step(actions, std::span(obs, agents * VecEnv<RNG>::obs_size), std::span(rewards, agents), std::span(dones, env->env.size()));
+        return SHAKTRIS_OK;
+    });
+}
+
+shaktris_status shaktris_env_action_masks(shaktris_env* env, uint64_t* out) {
+    if (!env || !out)
+        return SHAKTRIS_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        env->env.write_masks(std::span(out, env->env.agents() * Shaktris::ActionMask::words));
+        return SHAKTRIS_OK;
+    });
+}
+
+}
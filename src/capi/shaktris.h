@@ -0,0 +1,121 @@
+/* C interface to ShakTris, for calling the engine from Python, Rust and friends
+ * every entry point works on a batch and writes into flat buffers the caller owns,
+ * so one foreign call covers thousands of positions and nothing gets copied into or out of the library
+ *
+ * boards are SHAKTRIS_BOARD_WIDTH uint32_t columns each, bit y of column x set when the cell is filled
+ * piece types are S Z J L T O I = 0..6, and 7 for no piece
+ * a placement is 16 bits: type 0-2 | rotation 3-4 | x 5-8 | y 9-13 | spin 14-15,
+ * x and y are the rotation center, rotations go north east south west
+ */
+#ifndef SHAKTRIS_H
+#define SHAKTRIS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(SHAKTRIS_BUILDING_C_API)
+#define SHAKTRIS_API __declspec(dllexport)
+#else
+#define SHAKTRIS_API __declspec(dllimport)
+#endif
+#else
+#define SHAKTRIS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* bumped whenever a signature or a buffer layout changes */
+#define SHAKTRIS_ABI_VERSION 1
+
+#define SHAKTRIS_BOARD_WIDTH 10
+#define SHAKTRIS_BOARD_HEIGHT 32
+#define SHAKTRIS_PIECE_NONE 7
+
+/* action space of shaktris_action_masks, hold * 1280 + rotation * 320 + x * 32 + y */
+#define SHAKTRIS_ACTIONS 2560
+#define SHAKTRIS_MASK_WORDS 40
+
+/* what shaktris_action_placement gives when there is no placement, every real one is below it, the same value replays use for no move */
+#define SHAKTRIS_NO_PLACEMENT 0xffff
+
+typedef enum shaktris_status {
+    SHAKTRIS_OK = 0,
+    SHAKTRIS_INVALID_ARGUMENT = 1,
+    SHAKTRIS_OUT_OF_MEMORY = 2,
+    SHAKTRIS_INTERNAL_ERROR = 3
+} shaktris_status;
+
+/* owns the worker threads the batch calls run on, one context can be shared by any number of calls in sequence */
+typedef struct shaktris_context shaktris_context;
+
+/* a batch of self play games stepped together, see shaktris_env_step */
+typedef struct shaktris_env shaktris_env;
+
+SHAKTRIS_API uint32_t shaktris_abi_version(void);
+
+/* threads = 0 uses every hardware thread, returns NULL if it could not be made */
+SHAKTRIS_API shaktris_context* shaktris_context_create(uint32_t threads);
+SHAKTRIS_API void shaktris_context_destroy(shaktris_context* context);
+
+/* every grounded placement of types[i] on board i
+ * board i writes into out[i * stride ...] and its total into counts[i],
+ * a count above stride means the rest did not fit and was left out (1280 always fits)
+ */
+SHAKTRIS_API shaktris_status shaktris_movegen(shaktris_context* context, const uint32_t* boards, const uint8_t* types, size_t n,
+    uint16_t* out, size_t stride, uint32_t* counts);
+
+/* legal placement masks of n positions, SHAKTRIS_MASK_WORDS words each, action a is bit a % 64 of word a / 64
+ * the second half covers the piece hold gives: hold[i], or queue_front[i] when hold[i] is SHAKTRIS_PIECE_NONE
+ * an action maps back to a placement with shaktris_action_placement
+ */
+SHAKTRIS_API shaktris_status shaktris_action_masks(shaktris_context* context, const uint32_t* boards, const uint8_t* current,
+    const uint8_t* hold, const uint8_t* queue_front, size_t n, uint64_t* out);
+
+/* the placement of an action, spin left out, for a position whose current and hold piece are given
+ * SHAKTRIS_NO_PLACEMENT for an action out of range, a bad piece type, or an action on the half of a piece that is SHAKTRIS_PIECE_NONE
+ */
+SHAKTRIS_API uint16_t shaktris_action_placement(uint32_t action, uint8_t current, uint8_t hold_piece);
+
+/* checks one placement per board before trusting it, out[i] is 1 if placements[i] is among what shaktris_movegen gives
+ * for boards[i] with the same spin, and 0 otherwise, south and west I, S and Z count as their north and east twins
+ */
+SHAKTRIS_API shaktris_status shaktris_is_legal(shaktris_context* context, const uint32_t* boards, const uint16_t* placements, size_t n,
+    uint8_t* out);
+
+/* the built in board heuristic of n boards into scores, higher is better */
+SHAKTRIS_API shaktris_status shaktris_evaluate(shaktris_context* context, const uint32_t* boards, size_t n, float* scores);
+
+/* n versus games, two agents each, agent 2 * game + player, threads come from context which has to outlive the env */
+SHAKTRIS_API shaktris_env* shaktris_env_create(shaktris_context* context, size_t n, uint64_t seed);
+SHAKTRIS_API void shaktris_env_destroy(shaktris_env* env);
+
+SHAKTRIS_API size_t shaktris_env_size(const shaktris_env* env);
+/* floats in one agent's observation */
+SHAKTRIS_API size_t shaktris_env_observation_size(void);
+
+/* obs holds 2 * n observations */
+SHAKTRIS_API shaktris_status shaktris_env_reset(shaktris_env* env, float* obs);
+
+/* actions and rewards hold 2 * n entries, dones n, obs 2 * n observations
+ * actions are indices into the action space of shaktris_env_action_masks, an illegal one loses that agent the game
+ * reward is the attack sent, plus one for winning and minus one for losing, finished games restart on their own
+ */
+SHAKTRIS_API shaktris_status shaktris_env_step(shaktris_env* env, const uint32_t* actions, float* obs, float* rewards, uint8_t* dones);
+
+/* same step with placements, as shaktris_movegen writes them, instead of action indices
+ * a placement that is not reachable loses that agent the game, its spin bits are ignored and the board decides the spin
+ */
+SHAKTRIS_API shaktris_status shaktris_env_step_placements(shaktris_env* env, const uint16_t* placements, float* obs, float* rewards,
+    uint8_t* dones);
+
+/* 2 * n masks of SHAKTRIS_MASK_WORDS words, same layout as shaktris_action_masks */
+SHAKTRIS_API shaktris_status shaktris_env_action_masks(shaktris_env* env, uint64_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,141 @@
+/* smoke test of the C interface, compiled as plain C against shaktris.h so the header and the exports are checked from C
+ * runs every entry point once on a small batch and exits non zero on the first thing that is off
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shaktris.h"
+
+#define BATCH 7
+#define GAMES 4
+#define STEPS 200
+
+static int failures = 0;
+
+static void check(int ok, const char* what) {
+    if (!ok) {
+        fprintf(stderr, "failed: %s\n", what);
+        failures++;
+    }
+}
+
+int main(void) {
+    check(shaktris_abi_version() == SHAKTRIS_ABI_VERSION, "abi version matches the header");
+
+    shaktris_context* context = shaktris_context_create(2);
+    check(context != NULL, "context created");
+    if (!context)
+        return 1;
+
+    /* one empty board per piece type, and a little stack on the last one */
+    uint32_t boards[BATCH * SHAKTRIS_BOARD_WIDTH];
+    uint8_t types[BATCH];
+    memset(boards, 0, sizeof(boards));
+    for (int i = 0; i < BATCH; ++i)
+        types[i] = (uint8_t)i;
+    for (int x = 0; x < SHAKTRIS_BOARD_WIDTH - 1; ++x)
+        boards[(BATCH - 1) * SHAKTRIS_BOARD_WIDTH + x] = 0x3u;
+
+    enum { stride = 1280 };
+    uint16_t* placements = malloc(sizeof(uint16_t) * BATCH * stride);
+    uint32_t counts[BATCH];
+    check(placements != NULL, "placement buffer allocated");
+    if (!placements)
+        return 1;
+
+    check(shaktris_movegen(context, boards, types, BATCH, placements, stride, counts) == SHAKTRIS_OK, "movegen runs");
+    /* the same batch without a context runs on the calling thread and has to agree */
+    uint32_t serial_counts[BATCH];
+    uint16_t* serial = malloc(sizeof(uint16_t) * BATCH * stride);
+    check(serial != NULL, "serial buffer allocated");
+    if (!serial)
+        return 1;
+    check(shaktris_movegen(NULL, boards, types, BATCH, serial, stride, serial_counts) == SHAKTRIS_OK, "movegen runs without a context");
+    check(memcmp(counts, serial_counts, sizeof(counts)) == 0, "threaded and serial movegen give the same counts");
+
+    for (int i = 0; i < BATCH; ++i) {
+        check(counts[i] > 0 && counts[i] <= stride, "every piece has a placement");
+
+        uint8_t legal[stride];
+        uint32_t boards_i[stride * SHAKTRIS_BOARD_WIDTH];
+        for (uint32_t k = 0; k < counts[i]; ++k)
+            memcpy(boards_i + k * SHAKTRIS_BOARD_WIDTH, boards + i * SHAKTRIS_BOARD_WIDTH, sizeof(uint32_t) * SHAKTRIS_BOARD_WIDTH);
+        check(shaktris_is_legal(context, boards_i, placements + i * stride, counts[i], legal) == SHAKTRIS_OK, "is_legal runs");
+        int all = 1;
+        for (uint32_t k = 0; k < counts[i]; ++k)
+            all &= legal[k] == 1;
+        check(all, "every generated placement is legal");
+    }
+
+    uint8_t out;
+    check(shaktris_is_legal(context, NULL, placements, 1, &out) == SHAKTRIS_INVALID_ARGUMENT, "null boards are rejected");
+    check(shaktris_movegen(context, boards, NULL, 0, placements, stride, counts) == SHAKTRIS_OK, "an empty batch is fine");
+
+    float scores[BATCH];
+    check(shaktris_evaluate(context, boards, BATCH, scores) == SHAKTRIS_OK, "evaluate runs");
+    check(scores[0] > scores[BATCH - 1], "the empty board scores above the stacked one");
+
+    uint8_t hold[BATCH];
+    uint8_t front[BATCH];
+    for (int i = 0; i < BATCH; ++i) {
+        hold[i] = SHAKTRIS_PIECE_NONE;
+        front[i] = (uint8_t)((i + 1) % SHAKTRIS_PIECE_NONE);
+    }
+    uint64_t masks[BATCH * SHAKTRIS_MASK_WORDS];
+    check(shaktris_action_masks(context, boards, types, hold, front, BATCH, masks) == SHAKTRIS_OK, "action masks run");
+    /* 0 is a real placement, anything the call can not answer comes back as SHAKTRIS_NO_PLACEMENT */
+    check(shaktris_action_placement(0, 0, SHAKTRIS_PIECE_NONE) == 0, "action 0 maps to the raw placement 0");
+    check(shaktris_action_placement(SHAKTRIS_ACTIONS, 0, 1) == SHAKTRIS_NO_PLACEMENT, "an action out of range has no placement");
+    check(shaktris_action_placement(0, SHAKTRIS_PIECE_NONE + 1, 1) == SHAKTRIS_NO_PLACEMENT, "a bad piece type has no placement");
+    check(shaktris_action_placement(SHAKTRIS_ACTIONS / 2, 0, SHAKTRIS_PIECE_NONE) == SHAKTRIS_NO_PLACEMENT, "no hold piece has no placement");
+    front[0] = SHAKTRIS_PIECE_NONE + 1;
+    check(shaktris_action_masks(context, boards, types, hold, front, BATCH, masks) == SHAKTRIS_INVALID_ARGUMENT, "a bad piece type is rejected");
+
+    /* a few hundred steps of self play, each agent taking the first action its mask allows */
+    shaktris_env* env = shaktris_env_create(context, GAMES, 1234);
+    check(env != NULL, "env created");
+    if (env) {
+        check(shaktris_env_size(env) == GAMES, "env size");
+        const size_t obs_size = shaktris_env_observation_size();
+        float* obs = malloc(sizeof(float) * 2 * GAMES * obs_size);
+        uint64_t env_masks[2 * GAMES * SHAKTRIS_MASK_WORDS];
+        uint32_t actions[2 * GAMES];
+        float rewards[2 * GAMES];
+        uint8_t dones[GAMES];
+        check(obs != NULL, "observation buffer allocated");
+        if (obs) {
+            check(shaktris_env_reset(env, obs) == SHAKTRIS_OK, "env resets");
+            size_t finished = 0;
+            for (int step = 0; step < STEPS; ++step) {
+                check(shaktris_env_action_masks(env, env_masks) == SHAKTRIS_OK, "env masks");
+                for (int agent = 0; agent < 2 * GAMES; ++agent) {
+                    actions[agent] = 0;
+                    for (uint32_t a = 0; a < SHAKTRIS_ACTIONS; ++a) {
+                        if (env_masks[agent * SHAKTRIS_MASK_WORDS + a / 64] >> (a % 64) & 1) {
+                            actions[agent] = a;
+                            break;
+                        }
+                    }
+                }
+                check(shaktris_env_step(env, actions, obs, rewards, dones) == SHAKTRIS_OK, "env steps");
+                for (int game = 0; game < GAMES; ++game)
+                    finished += dones[game];
+            }
+            /* stacking in the first legal spot tops out long before 200 pieces */
+            check(finished > 0, "games finish and restart");
+            free(obs);
+        }
+        shaktris_env_destroy(env);
+    }
+    const uint32_t action = 0;
+    check(shaktris_env_step(NULL, &action, NULL, NULL, NULL) == SHAKTRIS_INVALID_ARGUMENT, "a null env is rejected");
+
+    free(serial);
+    free(placements);
+    shaktris_context_destroy(context);
+
+    if (failures == 0)
+        printf("c api smoke test: ok\n");
+    return failures != 0;
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Move.hpp"
+#include "VersusGame.hpp"
+#include "datagen/Shard.hpp"
+#include "engine/ActionMask.hpp"
+#include "engine/GameState.hpp"
+#include "engine/Placement.hpp"
+#include "util/bounded_queue.hpp"
+#include "util/hash.hpp"
+#include "util/randomizer.hpp"
+#include "util/rng.hpp"
+#include "util/threadpool.hpp"
+
+namespace Shaktris {
+    namespace DataGen {
+
+        struct DataGenConfig {
+            // shards go to prefix-00000.shkd, prefix-00001.shkd and so on
+            std::string prefix = "selfplay";
+            std::size_t records_per_shard = 1 << 20;
+            bool compress = true;
+            u64 seed = 0;
+            std::size_t games = 1024;
+            // games still running after this many turns are cut off, their records get outcome 0
+            int max_turns = 1000;
+        };
+
+        struct DataGenStats {
+            std::size_t games = 0;
+            u64 records = 0;
+            std::size_t shards = 0;
+            u64 bytes = 0;
+            // producer threads, the calling thread writes on top of them
+            std::size_t producers = 0;
+            // the producers and the writer, as many as the machine has
+            std::size_t cores = 0;
+            double seconds = 0;
+            bool ok = true;
+
+            double samples_per_second() const {
+                return seconds == 0 ? 0 : records / seconds;
+            }
+
+            double samples_per_second_per_core() const {
+                return cores == 0 ? 0 : samples_per_second() / cores;
+            }
+
+            // stored bytes over raw record bytes
+            double compression_ratio() const {
+                return records == 0 ? 0 : double(bytes) / double(records * sizeof(Record));
+            }
+        };
+
+        // the record of player id about to play move, outcome is filled in once the game is over
+        template <randomizer Randomizer>
+        Record make_record(const BasicVersusGame<Randomizer>& game, int id, const Move& move) {
+            const Game& player = game.get_game(id);
+            const GameState state = GameState::from(player);
+            const Placement placement(move.piece);
+
+            Record record{};
+            std::copy(state.board.board.begin(), state.board.board.end(), record.board.begin());
+            record.pieces = state.pieces;
+            record.b2b = state.b2b;
+            record.combo = state.combo;
+            // the policy can place south and west states, the label is the twin the masks hold
+            record.action = static_cast<u16>(ActionMask::index(placement.type() != player.current_piece.type, placement));
+            record.turn = static_cast<u16>(std::min<int>(game.turn, std::numeric_limits<u16>::max()));
+            record.garbage = static_cast<u8>(std::clamp(id == 0 ? game.p1_meter : game.p2_meter, 0, 255));
+            record.mode = state.mode;
+            record.player = static_cast<u8>(id);
+            return record;
+        }
+
+        // self play into shards
+        // every pool worker plays its own share of the games and hands finished records over in fixed chunks
+        // through a lock free queue, the calling thread is the only one touching the files
+        // chunks come back through a second queue so nothing allocates once the games are running
+        //
+        // policy(game, id, rng) is the same as for BatchSimulator and has to be safe to call from several threads
+        // game i is seeded from the config seed and i, so the set of records does not depend on the thread count,
+        // only their order in the shards does
+        template <class Policy, randomizer Randomizer = RNG>
+        DataGenStats generate(ThreadPool& pool, const DataGenConfig& config, Policy& policy) {
+            static constexpr std::size_t chunk_records = 256;
+            struct Chunk {
+                std::array<Record, chunk_records> records;
+                std::size_t count = 0;
+            };
+
+            const std::size_t producers = pool.size();
+            // enough that producers rarely wait on the writer
+            std::vector<Chunk> chunks(producers * 8);
+            BoundedQueue<Chunk*> free_chunks(chunks.size());
+            BoundedQueue<Chunk*> full_chunks(chunks.size());
+            for (Chunk& chunk : chunks)
+                free_chunks.try_push(&chunk);
+
+            std::atomic<std::size_t> running = producers;
+
+            auto produce = [&](std::size_t worker) {
+                std::vector<Record> game_records;
+                game_records.reserve(static_cast<std::size_t>(config.max_turns) * 2);
+                Chunk* chunk = nullptr;
+
+                auto emit = [&](const Record& record) {
+                    while (!chunk && !free_chunks.try_pop(chunk))
+                        std::this_thread::yield();
+                    chunk->records[chunk->count++] = record;
+                    if (chunk->count == chunk_records) {
+                        while (!full_chunks.try_push(chunk))
+                            std::this_thread::yield();
+                        chunk = nullptr;
+                    }
+                };
+
+                for (std::size_t i = worker; i < config.games; i += producers) {
+                    const u64 game_seed = hash_mix(config.seed + i);
+                    BasicVersusGame<Randomizer> game(static_cast<u32>(game_seed));
+                    RNG rng(static_cast<u32>(game_seed >> 32));
+                    Outcomes outcome = Outcomes::NONE;
+                    game_records.clear();
+
+                    for (int turn = 0; turn < config.max_turns && !game.game_over; ++turn) {
+                        const Move p1 = policy(game, 0, rng);
+                        const Move p2 = policy(game, 1, rng);
+                        if (p1.null_move || p2.null_move) {
+                            outcome = p1.null_move && p2.null_move ? Outcomes::DRAW : (p1.null_move ? Outcomes::P2_WIN : Outcomes::P1_WIN);
+                            break;
+                        }
+
+                        game_records.push_back(make_record(game, 0, p1));
+                        game_records.push_back(make_record(game, 1, p2));
+                        game.set_move(0, p1);
+                        game.set_move(1, p2);
+                        game.play_moves();
+                        if (game.game_over)
+                            outcome = game.get_winner();
+                    }
+
+                    for (Record& record : game_records) {
+                        if (outcome == Outcomes::P1_WIN || outcome == Outcomes::P2_WIN)
+                            record.outcome = (outcome == Outcomes::P1_WIN) == (record.player == 0) ? 1 : -1;
+                        emit(record);
+                    }
+                }
+
+                if (chunk && chunk->count) {
+                    while (!full_chunks.try_push(chunk))
+                        std::this_thread::yield();
+                }
+                running.fetch_sub(1, std::memory_order_release);
+            };
+
+            auto make_task = [&produce](std::size_t worker) { return [&produce, worker] { produce(worker); }; };
+            std::vector<decltype(make_task(0))> tasks;
+            tasks.reserve(producers);
+            for (std::size_t worker = 0; worker < producers; ++worker)
+                tasks.push_back(make_task(worker));
+
+            DataGenStats stats;
+            stats.games = config.games;
+            stats.producers = producers;
+            stats.cores = std::min<std::size_t>(producers + 1, std::max(1u, std::thread::hardware_concurrency()));
+
+            ShardWriter writer(config.prefix, config.records_per_shard, config.compress);
+            auto time_start = std::chrono::steady_clock::now();
+            {
+                TaskGroup group(pool);
+                for (auto& task : tasks)
+                    group.run(task);
+
+                // write until every producer is done and the queue is drained
+                // running is read before popping so a chunk pushed right before a producer finishes is never missed
+                for (;;) {
+                    const bool done = running.load(std::memory_order_acquire) == 0;
+                    Chunk* chunk = nullptr;
+                    if (full_chunks.try_pop(chunk)) {
+                        writer.write(std::span<const Record>(chunk->records.data(), chunk->count));
+                        chunk->count = 0;
+                        free_chunks.try_push(chunk);
+                    }
+                    else if (done) {
+                        break;
+                    }
+                    else {
+                        std::this_thread::yield();
+                    }
+                }
+                group.wait();
+            }
+            stats.ok = writer.close();
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+            stats.records = writer.records_written;
+            stats.shards = writer.shards;
+            stats.bytes = writer.bytes_written;
+            return stats;
+        }
+    };
+};
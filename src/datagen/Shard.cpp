@@ -0,0 +1,232 @@
+#include "Shard.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Shaktris {
+    namespace DataGen {
+
+        namespace {
+
+            constexpr std::byte zero_run{ 0x80 };
+            constexpr std::size_t max_run = 128;
+
+            std::size_t zeros_at(std::span<const std::byte> bytes, std::size_t i) {
+                std::size_t n = 0;
+                while (i + n < bytes.size() && n < max_run && bytes[i + n] == std::byte{ 0 })
+                    n++;
+                return n;
+            }
+
+        };
+
+        std::size_t compress(std::span<const Record> records, std::span<std::byte> out, std::span<std::byte> scratch) {
+            const std::size_t n = records.size();
+            const std::size_t total = n * sizeof(Record);
+            const std::byte* raw = reinterpret_cast<const std::byte*>(records.data());
+
+            // byte b of record i goes to b * n + i
+            for (std::size_t b = 0; b < sizeof(Record); ++b) {
+                std::byte* __restrict plane = scratch.data() + b * n;
+                for (std::size_t i = 0; i < n; ++i)
+                    plane[i] = raw[i * sizeof(Record) + b];
+            }
+
+            const std::span<const std::byte> shuffled = scratch.first(total);
+            std::size_t written = 0;
+            std::size_t i = 0;
+            while (i < total) {
+                const std::size_t zeros = zeros_at(shuffled, i);
+                if (zeros >= 2) {
+                    out[written++] = zero_run | std::byte(zeros - 1);
+                    i += zeros;
+                    continue;
+                }
+
+                // literals until the next run of two zeros
+                std::size_t length = 0;
+                while (i + length < total && length < max_run && zeros_at(shuffled, i + length) < 2)
+                    length++;
+                out[written++] = std::byte(length - 1);
+                std::memcpy(out.data() + written, shuffled.data() + i, length);
+                written += length;
+                i += length;
+            }
+            return written;
+        }
+
+        bool decompress(std::span<const std::byte> in, std::span<Record> out, std::span<std::byte> scratch) {
+            const std::size_t n = out.size();
+            const std::size_t total = n * sizeof(Record);
+
+            std::size_t read = 0;
+            std::size_t i = 0;
+            while (read < in.size()) {
+                const std::byte control = in[read++];
+                const std::size_t length = std::to_integer<std::size_t>(control & std::byte{ 0x7f }) + 1;
+                if (i + length > total)
+                    return false;
+
+                if ((control & zero_run) != std::byte{ 0 }) {
+                    std::memset(scratch.data() + i, 0, length);
+                }
+                else {
+                    if (read + length > in.size())
+                        return false;
+                    std::memcpy(scratch.data() + i, in.data() + read, length);
+                    read += length;
+                }
+                i += length;
+            }
+            if (i != total)
+                return false;
+
+            std::byte* raw = reinterpret_cast<std::byte*>(out.data());
+            for (std::size_t b = 0; b < sizeof(Record); ++b) {
+                const std::byte* __restrict plane = scratch.data() + b * n;
+                for (std::size_t r = 0; r < n; ++r)
+                    raw[r * sizeof(Record) + b] = plane[r];
+            }
+            return true;
+        }
+
+        std::string shard_path(const std::string& prefix, std::size_t shard) {
+            char number[16];
+            std::snprintf(number, sizeof(number), "-%05zu.shkd", shard);
+            return prefix + number;
+        }
+
+        ShardWriter::ShardWriter(std::string prefix, std::size_t records_per_shard, bool compressed)
+            : prefix(std::move(prefix)), records_per_shard(std::max(records_per_shard, block_records)), compressed(compressed) {
+            block.reserve(block_records);
+            encoded.resize(compress_bound(block_records));
+            scratch.resize(block_records * sizeof(Record));
+            index.reserve(this->records_per_shard / block_records + 1);
+        }
+
+        ShardWriter::~ShardWriter() {
+            close();
+        }
+
+        void ShardWriter::write(std::span<const Record> records) {
+            while (!records.empty()) {
+                const std::size_t n = std::min(records.size(), block_records - block.size());
+                block.insert(block.end(), records.begin(), records.begin() + n);
+                records = records.subspan(n);
+                if (block.size() == block_records)
+                    flush_block();
+            }
+        }
+
+        void ShardWriter::open_shard() {
+            file = std::fopen(shard_path(prefix, shards).c_str(), "wb");
+            failed |= file == nullptr;
+            offset = 0;
+            shard_records = 0;
+            index.clear();
+
+            ShardHeader header;
+            header.block_records = block_records;
+            header.compressed = compressed;
+            if (file)
+                failed |= std::fwrite(&header, sizeof(header), 1, file) != 1;
+            offset += sizeof(header);
+            shards++;
+        }
+
+        void ShardWriter::flush_block() {
+            if (block.empty())
+                return;
+            if (!file)
+                open_shard();
+
+            const std::byte* data = reinterpret_cast<const std::byte*>(block.data());
+            std::size_t bytes = block.size() * sizeof(Record);
+            if (compressed) {
+                bytes = compress(block, encoded, scratch);
+                data = encoded.data();
+            }
+
+            if (file)
+                failed |= std::fwrite(data, 1, bytes, file) != bytes;
+            index.push_back({ offset, static_cast<u32>(bytes), static_cast<u32>(block.size()) });
+            offset += bytes;
+            bytes_written += bytes;
+            records_written += block.size();
+            shard_records += block.size();
+            block.clear();
+
+            if (shard_records >= records_per_shard)
+                close_shard();
+        }
+
+        void ShardWriter::close_shard() {
+            if (!file)
+                return;
+
+            ShardFooter footer;
+            footer.index_offset = offset;
+            footer.blocks = static_cast<u32>(index.size());
+            failed |= std::fwrite(index.data(), sizeof(ShardIndexEntry), index.size(), file) != index.size();
+            failed |= std::fwrite(&footer, sizeof(footer), 1, file) != 1;
+            failed |= std::fclose(file) != 0;
+            file = nullptr;
+        }
+
+        bool ShardWriter::close() {
+            flush_block();
+            close_shard();
+            return !failed;
+        }
+
+        bool ShardReader::open(const std::string& path) {
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if (!in)
+                return false;
+            contents.resize(static_cast<std::size_t>(in.tellg()));
+            in.seekg(0);
+            if (!in.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(contents.size())))
+                return false;
+
+            ShardFooter footer;
+            if (contents.size() < sizeof(ShardHeader) + sizeof(ShardFooter))
+                return false;
+            std::memcpy(&header, contents.data(), sizeof(header));
+            std::memcpy(&footer, contents.data() + contents.size() - sizeof(footer), sizeof(footer));
+            if (header.magic != ShardHeader::expected_magic || header.version != ShardHeader::current_version ||
+                header.record_size != sizeof(Record) || footer.magic != ShardFooter::expected_magic ||
+                footer.index_offset + footer.blocks * sizeof(ShardIndexEntry) + sizeof(footer) != contents.size())
+                return false;
+
+            index.resize(footer.blocks);
+            std::memcpy(index.data(), contents.data() + footer.index_offset, footer.blocks * sizeof(ShardIndexEntry));
+            scratch.resize(header.block_records * sizeof(Record));
+            return true;
+        }
+
+        std::size_t ShardReader::records() const {
+            std::size_t n = 0;
+            for (const ShardIndexEntry& entry : index)
+                n += entry.records;
+            return n;
+        }
+
+        bool ShardReader::read_block(std::size_t i, std::vector<Record>& out) {
+            const ShardIndexEntry& entry = index[i];
+            if (entry.offset + entry.stored_bytes > contents.size() || entry.records > header.block_records)
+                return false;
+
+            const std::size_t start = out.size();
+            out.resize(start + entry.records);
+            const std::span<const std::byte> stored(contents.data() + entry.offset, entry.stored_bytes);
+            if (!header.compressed) {
+                if (entry.stored_bytes != entry.records * sizeof(Record))
+                    return false;
+                std::memcpy(static_cast<void*>(out.data() + start), stored.data(), stored.size());
+                return true;
+            }
+            return decompress(stored, std::span(out).subspan(start), scratch);
+        }
+    };
+};
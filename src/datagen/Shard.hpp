@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "engine/Board.hpp"
+#include "engine/ShaktrisConstants.hpp"
+
+namespace Shaktris {
+    namespace DataGen {
+
+        // one training sample, a position of one player and what they played from it
+        // fixed size so shards are plain arrays of these once decompressed
+        struct Record {
+            std::array<column_t, Board::width> board;
+            // GameState::pieces, current | hold | has hold | queue three bits each
+            u64 pieces;
+            u16 b2b;
+            u16 combo;
+            // Shaktris::ActionMask index of the placement that was played
+            u16 action;
+            u16 turn;
+            // garbage waiting for this player
+            u8 garbage;
+            u8 mode;
+            // 1 if this player went on to win, -1 if they lost, 0 for a draw or a game cut off
+            i8 outcome;
+            u8 player;
+            u32 reserved;
+        };
+
+        static_assert(sizeof(Record) == 64 && std::is_trivially_copyable_v<Record>, "records should be 64 bytes");
+        static_assert(std::endian::native == std::endian::little, "shards are written in memory order");
+
+        // shard = header | block | block | ... | index | footer
+        // a block is up to block_records records, stored raw or compressed, the index has the offset of every block
+        struct ShardHeader {
+            static constexpr std::array<char, 4> expected_magic = { 'S', 'H', 'K', 'D' };
+            static constexpr u16 current_version = 1;
+
+            std::array<char, 4> magic = expected_magic;
+            u16 version = current_version;
+            u16 record_size = sizeof(Record);
+            u32 block_records = 0;
+            u32 compressed = 0;
+        };
+
+        struct ShardIndexEntry {
+            u64 offset;
+            u32 stored_bytes;
+            u32 records;
+        };
+
+        struct ShardFooter {
+            static constexpr std::array<char, 4> expected_magic = { 'S', 'H', 'K', 'I' };
+
+            u64 index_offset;
+            u32 blocks;
+            std::array<char, 4> magic = expected_magic;
+        };
+
+        static_assert(sizeof(ShardHeader) == 16 && sizeof(ShardIndexEntry) == 16 && sizeof(ShardFooter) == 16, "shard layout changed");
+
+        // byte shuffle then zero run length coding, the same byte of consecutive records ends up next to each other
+        // and most of them (high board rows, empty hold, small counters) are zero, so runs are long
+        // out has to hold compress_bound(n) bytes, returns the bytes written
+        std::size_t compress(std::span<const Record> records, std::span<std::byte> out, std::span<std::byte> scratch);
+        // out holds the records that were compressed, returns false on corrupt input
+        bool decompress(std::span<const std::byte> in, std::span<Record> out, std::span<std::byte> scratch);
+
+        constexpr std::size_t compress_bound(std::size_t records) {
+            // worst case is all literals, one control byte per 128
+            const std::size_t bytes = records * sizeof(Record);
+            return bytes + bytes / 128 + 1;
+        }
+
+        // writes records into numbered shards, prefix-00000.shkd and on, rolling over every records_per_shard records
+        // all block buffers are sized up front, the only allocation after the constructor is a shard's file name
+        class ShardWriter {
+           public:
+            static constexpr std::size_t block_records = 512;
+
+            ShardWriter(std::string prefix, std::size_t records_per_shard, bool compressed);
+            ~ShardWriter();
+
+            ShardWriter(const ShardWriter&) = delete;
+            ShardWriter& operator=(const ShardWriter&) = delete;
+
+            void write(std::span<const Record> records);
+
+            // finishes the open shard, false if anything failed to write
+            bool close();
+
+            std::size_t shards = 0;
+            u64 records_written = 0;
+            u64 bytes_written = 0;
+
+           private:
+            void flush_block();
+            void open_shard();
+            void close_shard();
+
+            std::string prefix;
+            std::size_t records_per_shard;
+            bool compressed;
+            bool failed = false;
+
+            std::FILE* file = nullptr;
+            u64 offset = 0;
+            std::size_t shard_records = 0;
+
+            std::vector<Record> block;
+            std::vector<std::byte> encoded;
+            std::vector<std::byte> scratch;
+            std::vector<ShardIndexEntry> index;
+        };
+
+        std::string shard_path(const std::string& prefix, std::size_t shard);
+
+        // reads a whole shard back
+        class ShardReader {
+           public:
+            bool open(const std::string& path);
+
+            std::size_t blocks() const {
+                return index.size();
+            }
+
+            std::size_t records() const;
+
+            // appends block i to out, false if it does not decode
+            bool read_block(std::size_t i, std::vector<Record>& out);
+
+            ShardHeader header;
+            std::vector<ShardIndexEntry> index;
+
+           private:
+            std::vector<std::byte> contents;
+            std::vector<std::byte> scratch;
+        };
+    };
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "Board.hpp"
+#include "Game.hpp"
+#include "MoveGen.hpp"
+#include "MoveSampling.hpp"
+#include "Piece.hpp"
+#include "Placement.hpp"
+#include "ShaktrisConstants.hpp"
+
+namespace Shaktris {
+    namespace ActionMask {
+
+        // a fixed action space for policies, one action per (hold, rotation, x, y)
+        // action = hold * per_piece + rotation * Board::width * Board::height + x * Board::height + y
+        // which is exactly the bit order of the smeared movegen planes, so building a mask is copying columns
+        constexpr std::size_t per_piece = RotationDirections_N * Board::width * Board::height;
+        constexpr std::size_t size = 2 * per_piece;
+
+        // as bits, action i is bit i % 64 of word i / 64
+        constexpr std::size_t words_per_piece = per_piece / 64;
+        constexpr std::size_t words = 2 * words_per_piece;
+
+        static_assert(Board::height == 32 && Board::width % 2 == 0, "two columns per mask word");
+
+        constexpr std::size_t index(bool hold, RotationDirection rotation, Coord position) {
+            return (hold ? per_piece : 0) + static_cast<std::size_t>(rotation) * Board::width * Board::height +
+                static_cast<std::size_t>(position.x) * Board::height + static_cast<std::size_t>(position.y);
+        }
+
+        // index of any placement of the piece, south and west of I, S and Z and the turned states of O
+        // go to the twin covering the same cells, which is the only one the masks ever hold
+        inline std::size_t index(bool hold, Placement placement) {
+            const MoveGen::Smeared::SmearedPiece canonical =
+                MoveGen::Smeared::cannonicalize({ placement.position(), static_cast<u8>(placement.rotation()) }, placement.type());
+            return index(hold, static_cast<RotationDirection>(canonical.rot), canonical.position);
+        }
+
+        constexpr RotationDirection rotation(std::size_t action) {
+            return static_cast<RotationDirection>((action % per_piece) / (Board::width * Board::height));
+        }
+
+        constexpr Coord position(std::size_t action) {
+            return Coord{ static_cast<i8>((action / Board::height) % Board::width), static_cast<i8>(action % Board::height) };
+        }
+
+        constexpr bool uses_hold(std::size_t action) {
+            return action >= per_piece;
+        }
+
+        // the legal placements of a game, the current piece first and the piece hold gives second
+        // when hold would give the same piece (or none) its half of the mask is empty
+        struct Masks {
+            std::array<MoveGen::Sampling::PlacementSet, 2> sets{};
+
+            bool legal(std::size_t action) const {
+                const column_t column = sets[uses_hold(action)].moves.boards[static_cast<std::size_t>(rotation(action))].board[static_cast<std::size_t>(position(action).x)];
+                return (column >> position(action).y) & 1;
+            }
+
+            // what the action places, spin included, only meaningful for legal actions
+            Placement placement(std::size_t action) const {
+                const MoveGen::Sampling::PlacementSet& set = sets[uses_hold(action)];
+                const RotationDirection rot = rotation(action);
+                const Coord pos = position(action);
+                const bool spin = (set.spins.boards[static_cast<std::size_t>(rot)].board[static_cast<std::size_t>(pos.x)] >> pos.y) & 1;
+                return Placement(set.type, rot, pos, spin ? spinType::normal : spinType::null);
+            }
+
+            Piece piece(std::size_t action) const {
+                return placement(action).to_piece();
+            }
+
+            // action of a placement of either piece in any of its states, the inverse of placement
+            std::size_t action(Placement placement) const {
+                return index(placement.type() != sets[0].type, placement);
+            }
+
+            std::size_t count() const {
+                return sets[0].count + sets[1].count;
+            }
+
+            void write(std::span<u64, words> out) const {
+                for (std::size_t hold = 0; hold < 2; ++hold) {
+                    const auto& boards = sets[hold].moves.boards;
+                    for (std::size_t rot = 0; rot < RotationDirections_N; ++rot) {
+                        for (std::size_t x = 0; x < Board::width; x += 2) {
+                            out[hold * words_per_piece + (rot * Board::width + x) / 2] =
+                                u64(boards[rot].board[x]) | (u64(boards[rot].board[x + 1]) << 32);
+                        }
+                    }
+                }
+            }
+
+            // one byte per action, for frameworks that want a bool tensor
+            void write(std::span<u8, size> out) const {
+                for (std::size_t hold = 0; hold < 2; ++hold) {
+                    const auto& boards = sets[hold].moves.boards;
+                    for (std::size_t rot = 0; rot < RotationDirections_N; ++rot) {
+                        for (std::size_t x = 0; x < Board::width; ++x) {
+                            const column_t column = boards[rot].board[x];
+                            u8* __restrict cells = out.data() + index(hold, static_cast<RotationDirection>(rot), Coord{ static_cast<i8>(x), 0 });
+                            for (std::size_t y = 0; y < Board::height; ++y)
+                                cells[y] = static_cast<u8>((column >> y) & 1);
+                        }
+                    }
+                }
+            }
+        };
+
+        // same placements as Game::get_possible_placements, straight from the smeared planes
+        template <class Mode, std::size_t Preview>
+        inline Masks masks(const BasicGame<Mode, Preview>& game) {
+            Masks ret;
+            MoveGen::Sampling::placement_sets(game, ret.sets);
+            return ret;
+        }
+    };
+};
+
+// sanity test
+consteval bool action_mask_index_test() {
+    using namespace Shaktris::ActionMask;
+    for (std::size_t action = 0; action < size; ++action) {
+        if (index(uses_hold(action), rotation(action), position(action)) != action)
+            return false;
+    }
+    return size == 2560 && words == 40;
+}
+
+static_assert(action_mask_index_test(), "action mask index didnt work");
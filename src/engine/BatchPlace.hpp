@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "../util/pext.hpp"
+#include "Board.hpp"
+#include "Piece.hpp"
+#include "ShaktrisConstants.hpp"
+
+namespace Shaktris {
+    namespace Batch {
+
+        // every child of one board after placing a piece and clearing lines, stored column major
+        // so the same column of consecutive children sits next to each other in memory,
+        // which is what lets the kernel below (and evaluation after it) run across children in simd lanes
+        struct ChildBoards {
+            std::array<std::vector<column_t>, Board::width> columns;  // columns[x][child]
+            std::vector<column_t> cleared_rows;                       // rows that were full, before clearing
+            std::vector<u8> lines_cleared;
+            std::vector<u8> perfect_clear;
+            std::vector<spinType> spin;
+            std::size_t count = 0;
+
+            // only ever grows the buffers so reusing one ChildBoards per search depth never allocates
+            void resize(std::size_t n) {
+                if (n > cleared_rows.size()) {
+                    for (auto& column : columns)
+                        column.resize(n);
+                    cleared_rows.resize(n);
+                    lines_cleared.resize(n);
+                    perfect_clear.resize(n);
+                    spin.resize(n);
+                }
+                count = n;
+            }
+
+            Board board(std::size_t i) const {
+                Board ret;
+                for (std::size_t x = 0; x < Board::width; ++x)
+                    ret.board[x] = columns[x][i];
+                return ret;
+            }
+        };
+
+        // same result as copying the board, Board::set(piece) and Board::clearLines() once per move
+        inline void place_and_clear(const Board& board, std::span<const Piece> moves, ChildBoards& out) {
+            const std::size_t n = moves.size();
+            out.resize(n);
+
+            // start every child from the parent
+            for (std::size_t x = 0; x < Board::width; ++x) {
+                column_t* __restrict col = out.columns[x].data();
+                const column_t parent = board.board[x];
+                for (std::size_t i = 0; i < n; ++i)
+                    col[i] = parent;
+            }
+
+            // stamp the pieces in, four scattered ors per child
+            for (std::size_t i = 0; i < n; ++i) {
+                const Piece& piece = moves[i];
+                for (const Coord& mino : piece.minos) {
+                    const std::size_t x = static_cast<std::size_t>(mino.x + piece.position.x);
+                    out.columns[x][i] |= column_t(1) << (mino.y + piece.position.y);
+                }
+                out.spin[i] = piece.spin;
+            }
+
+            // full rows, one lane per child
+            column_t* __restrict full = out.cleared_rows.data();
+            for (std::size_t i = 0; i < n; ++i)
+                full[i] = ~column_t(0);
+            for (std::size_t x = 0; x < Board::width; ++x) {
+                const column_t* __restrict col = out.columns[x].data();
+                for (std::size_t i = 0; i < n; ++i)
+                    full[i] &= col[i];
+            }
+
+            // a child is a perfect clear if nothing is left outside of its full rows
+            u8* __restrict pc = out.perfect_clear.data();
+            u8* __restrict lines = out.lines_cleared.data();
+            for (std::size_t i = 0; i < n; ++i) {
+                pc[i] = 1;
+                lines[i] = static_cast<u8>(std::popcount(full[i]));
+            }
+            for (std::size_t x = 0; x < Board::width; ++x) {
+                const column_t* __restrict col = out.columns[x].data();
+                for (std::size_t i = 0; i < n; ++i)
+                    pc[i] &= (col[i] & ~full[i]) == 0;
+            }
+
+            // line clears are rare, so pext only the children that need it
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!full[i])
+                    continue;
+                const column_t keep = ~full[i];
+                for (std::size_t x = 0; x < Board::width; ++x)
+                    out.columns[x][i] = pext(out.columns[x][i], keep);
+            }
+        }
+    };
+};
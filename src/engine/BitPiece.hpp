@@ -100,6 +100,7 @@ public:
 		bit_piece = other.bit_piece;
 		pos.x = other.pos.x;
 		pos.y = other.pos.y;
+		rotation = other.rotation;
 		spin = other.spin;
 		type = other.type;
 	}
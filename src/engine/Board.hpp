@@ -77,6 +77,31 @@ public:
         return lines_cleared;
     }
 
+    // same as clearLines, but also hands back which rows were cleared so restoreLines can put them back
+    constexpr inline int clearLines(column_t& cleared_rows) {
+        column_t mask = std::numeric_limits<column_t>::max();
+        for (column_t& column : board)
+            mask &= column;
+        cleared_rows = mask;
+        int lines_cleared = std::popcount(mask);
+        mask = ~mask;
+
+        for (column_t& column : board)
+            column = pext(column, mask);
+
+        return lines_cleared;
+    }
+
+    // undoes clearLines, cleared rows were full so they come back full
+    constexpr inline void restoreLines(column_t cleared_rows) {
+        if (!cleared_rows)
+            return;
+
+        const column_t keep = ~cleared_rows;
+        for (column_t& column : board)
+            column = pdep(column, keep) | cleared_rows;
+    }
+
     constexpr inline int filledRows() {
         column_t mask = UINT32_MAX;
         for (column_t& column : board)
@@ -259,16 +284,19 @@ public:
             }
 
         }
-        offset_horizontal(dx);
+        if (dx)
+            offset_horizontal(dx);
     }
 
+    // moves every column shift to the right, columns moved in from outside are empty
     constexpr void offset_horizontal(int shift) {
-        for (size_t x = 1; x < Board::width - 1; ++x) {
-            auto& smear_col = board[x];
-            auto& tmp_col = board[x - shift];
-
-            smear_col = tmp_col;
+        std::array<column_t, Board::width> shifted{};
+        for (size_t x = 0; x < Board::width; ++x) {
+            const int from = (int)x - shift;
+            if (from >= 0 && from < (int)Board::width)
+                shifted[x] = board[static_cast<size_t>(from)];
         }
+        board = shifted;
     }
 
     constexpr void zero() {
@@ -292,4 +320,28 @@ public:
     }
 
     std::array<column_t, Board::width> board;
-};
\ No newline at end of file
+};
+
+// compile time unit tests for sanity
+consteval bool board_restore_test() {
+    Board board;
+    for (size_t x = 0; x < Board::width; ++x) {
+        board.set(x, 0);
+        board.set(x, 2);
+        board.set(x, 3);
+    }
+    board.set(1, 1);
+    board.set(4, 4);
+    board.set(7, 6);
+
+    Board cleared = board;
+    column_t cleared_rows = 0;
+    if (cleared.clearLines(cleared_rows) != 3 || cleared_rows != 0b1101)
+        return false;
+
+    cleared.restoreLines(cleared_rows);
+    return cleared == board;
+}
+
+// you will see this as a compile time error if it didnt work
+static_assert(board_restore_test(), "board_restore_test didnt work");
@@ -1,8 +1,12 @@
 #pragma once
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <concepts>
+#include <cstddef>
 #include <optional>
 #include <ranges>
+#include <type_traits>
 #include <vector>
 #include <variant>
 
@@ -12,35 +16,80 @@
 //#include "BitPiece.hpp"
 
 #include "ShaktrisConstants.hpp"
+#include "../util/hash.hpp"
+
+#include "MoveGen.hpp"
+#include "PieceQueue.hpp"
+#include "Placement.hpp"
+#include "RotationSystems.hpp"
+#include "Utility.hpp"
 
 #include "modes/TetrioS1.hpp"
 #include "modes/Botris.hpp"
 
 
-constexpr int QUEUE_SIZE = 6;
+// default preview length, what TETR.IO and Botris show
+constexpr std::size_t QUEUE_SIZE = 6;
+
+// a scoring mode turns a clear into garbage and keeps combo and b2b up to date, like TetrioS1 and Botris
+template <class Mode>
+concept points_mode = requires(Mode mode, int lines, spinType spin, bool pc, u16& combo, u16& b2b) {
+    { mode.points(lines, spin, pc, combo, b2b) } -> std::convertible_to<std::size_t>;
+};
+
+// every mode the type erased Game can switch between at runtime
+using GameModes = std::variant<TetrioS1, Botris>;
+
+template <class Mode>
+concept game_mode = points_mode<Mode> || std::same_as<Mode, GameModes>;
+
+// position of a mode inside GameModes, used as the mode tag by hashing and GameState
+template <class Mode, std::size_t I = 0>
+consteval std::size_t mode_index() {
+    if constexpr (I >= std::variant_size_v<GameModes>)
+        return I;
+    else if constexpr (std::same_as<Mode, std::variant_alternative_t<I, GameModes>>)
+        return I;
+    else
+        return mode_index<Mode, I + 1>();
+}
 
-class Game {
+// a mode's 180 kicks the way the movegens take them, as a template argument that is nullptr for modes without 180s
+template <class Mode>
+constexpr const KickTable180* movegen_kicks_180 = Mode::kicks_180.kicks == 0 ? nullptr : &Mode::kicks_180;
+
+// Game for one scoring mode known at compile time, damage_sent calls straight into it so it can inline
+// BasicGame<GameModes> is the type erased version that picks the mode at runtime, that one is Game
+// Preview is how many pieces the queue shows, longer ones are for lookahead and cost nothing per placement
+template <game_mode Mode, std::size_t Preview = QUEUE_SIZE>
+class BasicGame {
    public:
-    Game() : current_piece(PieceType::Empty) {
-        for (auto& p : queue) {
-            p = PieceType::Empty;
-        }
-        mode = Botris();
-    }
-    Game& operator=(const Game& other) {
-        if (this != &other) {
-            board = other.board;
-            current_piece = other.current_piece;
-            hold = other.hold;
-            queue = other.queue;
-            garbage_meter = other.garbage_meter;
-            b2b = other.b2b;
-            combo = other.combo;
-            mode = other.mode;
-        }
-        return *this;
+    // everything make changes, enough for unmake to put it all back
+    struct Undo {
+        Piece current_piece;
+        std::optional<PieceType> hold;
+        PieceQueue<Preview> queue;
+        Mode mode;
+        u16 b2b;
+        u16 combo;
+
+        // the placed piece, minos come back from rot_piece_def
+        Coord position;
+        RotationDirection rotation;
+        PieceType type;
+
+        column_t cleared_rows;
+
+        // what the placement did, handy for the caller
+        u8 lines_cleared;
+        bool perfect_clear;
+        int damage;
+    };
+
+    BasicGame() : current_piece(PieceType::Empty) {
+        if constexpr (std::same_as<Mode, GameModes>)
+            mode = Botris();
     }
-    ~Game() {}
 
     void place_piece();
 
@@ -48,23 +97,271 @@ class Game {
 
     void do_hold();
 
+    // deals a fresh current piece and queue, rng is anything with getPiece and fill_bags
+    template <class Randomizer>
+    void deal(Randomizer& rng) {
+        current_piece = rng.getPiece();
+        std::array<PieceType, Preview> next;
+        rng.fill_bags(next);
+        queue = PieceQueue<Preview>(next);
+    }
+
     void add_garbage(int lines, int location);
 
     int damage_sent(int linesCleared, spinType spinType, bool pc);
 
+    // places the piece, clears lines and scores the attack, like a turn of VersusGame without the garbage
+    // lets a search walk the tree with a single Game instead of copying it for every child
+    Undo make(const Piece& piece);
+
+    // restores the state from before the make that returned undo, has to be undone in reverse order
+    void unmake(const Undo& undo);
+
     void process_movement(Piece& piece, Movement movement) const;
 
     std::vector<Piece> get_possible_piece_placements() const;
 
+    // same moves in the same order, packed and appended to out so the caller can keep reusing one vector
+    void get_possible_placements(std::vector<Placement>& out) const;
+
+    // every field, hash() can collide where this can not
+    bool operator==(const BasicGame& other) const = default;
+
+    // position hash for transposition tables, covers everything that affects future play
+    u64 hash() const;
+
+    // 180 kicks of the active mode, what Movement::Rotate180 turns with
+    const KickTable180& kicks_180() const {
+        if constexpr (std::same_as<Mode, GameModes>)
+            return std::visit([](const auto& mode) -> const KickTable180& { return mode.kicks_180; }, mode);
+        else
+            return Mode::kicks_180;
+    }
+
+    // f.template operator()<Kicks180>() with the active mode's movegen_kicks_180, so the movegens turn 180s where the mode does
+    template <class F>
+    decltype(auto) visit_kicks_180(F&& f) const {
+        if constexpr (std::same_as<Mode, GameModes>)
+            return std::visit([&](const auto& mode) -> decltype(auto) {
+                return f.template operator()<movegen_kicks_180<std::decay_t<decltype(mode)>>>();
+            }, mode);
+        else
+            return f.template operator()<movegen_kicks_180<Mode>>();
+    }
+
+    // index of the active mode inside GameModes
+    std::size_t mode_index() const {
+        if constexpr (std::same_as<Mode, GameModes>)
+            return mode.index();
+        else
+            return ::mode_index<Mode>();
+    }
+
     Board board;
     Piece current_piece;
     std::optional<PieceType> hold;
     u8 garbage_meter = 0;
     u16 b2b = 0;
     u16 combo = 0;
-    std::array<PieceType, QUEUE_SIZE> queue;
+    PieceQueue<Preview> queue;
+
+    Mode mode{};
+};
+
+using Game = BasicGame<GameModes>;
+using GameUndo = Game::Undo;
+
+static_assert(std::is_trivially_copyable_v<Game>, "Game should copy with a memcpy");
+
+template <game_mode Mode, std::size_t Preview>
+void BasicGame<Mode, Preview>::place_piece() {
+    board.set(current_piece);
+
+    current_piece = queue.pop_front();
+}
+
+template <game_mode Mode, std::size_t Preview>
+void BasicGame<Mode, Preview>::do_hold() {
+
+    if (hold) {
+        PieceType current_piece_type = hold.value();
+        hold = current_piece.type;
+        current_piece = current_piece_type;
+    }
+    else {
+        hold = current_piece.type;
+
+        current_piece = queue.pop_front();
+    }
+}
+
+template <game_mode Mode, std::size_t Preview>
+bool BasicGame<Mode, Preview>::place_piece(const Piece& piece) {
+    bool first_hold = false;
+    if (piece.type != current_piece.type) {
+        if (!hold.has_value())
+        {  // the held piece came out of the queue
+            queue.pop_front();
+
+            first_hold = true;
+        }
+        hold = current_piece.type;
+    }
+
+    current_piece = piece;
+    place_piece();
+
+    return first_hold;
+}
+
+template <game_mode Mode, std::size_t Preview>
+typename BasicGame<Mode, Preview>::Undo BasicGame<Mode, Preview>::make(const Piece& piece) {
+    Undo undo{
+        current_piece,
+        hold,
+        queue,
+        mode,
+        b2b,
+        combo,
+        piece.position,
+        piece.rotation,
+        piece.type,
+        0,
+        0,
+        false,
+        0,
+    };
+
+    place_piece(piece);
+
+    undo.lines_cleared = (u8)board.clearLines(undo.cleared_rows);
+    undo.perfect_clear = board.is_empty();
+    undo.damage = damage_sent(undo.lines_cleared, piece.spin, undo.perfect_clear);
+
+    return undo;
+}
+
+template <game_mode Mode, std::size_t Preview>
+void BasicGame<Mode, Preview>::unmake(const Undo& undo) {
+    board.restoreLines(undo.cleared_rows);
+    board.unset(Piece(undo.type, undo.rotation, undo.position));
+
+    current_piece = undo.current_piece;
+    hold = undo.hold;
+    queue = undo.queue;
+    mode = undo.mode;
+    b2b = undo.b2b;
+    combo = undo.combo;
+}
+
+template <game_mode Mode, std::size_t Preview>
+void BasicGame<Mode, Preview>::add_garbage(int lines, int location) {
+    for (size_t i = 0; i < Board::width; ++i) {
+        auto& column = board.board[i];
+
+        column <<= lines;
+
+        if (location != i) {
+            column |= (1 << lines) - 1;
+        }
+    }
+}
+
+// ported from
+// https://github.com/emmachase/tetrio-combo
+template <game_mode Mode, std::size_t Preview>
+int BasicGame<Mode, Preview>::damage_sent(int linesCleared, spinType spinType, bool pc) {
+    if constexpr (points_mode<Mode>) {
+        return (int)mode.points(linesCleared, spinType, pc, combo, b2b);
+    }
+    else {
+        return std::visit([&](auto& mode) { return (int)mode.points(linesCleared, spinType, pc, combo, b2b); }, mode);
+    }
+}
+
+template <game_mode Mode, std::size_t Preview>
+void BasicGame<Mode, Preview>::process_movement(Piece& piece, Movement movement) const {
+    switch (movement) {
+        case Movement::Left:
+            Shaktris::Utility::shift(board, piece, -1);
+            break;
+        case Movement::Right:
+            Shaktris::Utility::shift(board, piece, 1);
+            break;
+        case Movement::RotateClockwise:
+            srs_rotate(board, piece, TurnDirection::Right);
+            break;
+        case Movement::RotateCounterClockwise:
+            srs_rotate(board, piece, TurnDirection::Left);
+            break;
+        case Movement::SonicDrop:
+            Shaktris::Utility::sonic_drop(board, piece);
+            break;
+        case Movement::Rotate180:
+            srs_rotate_180(board, piece, kicks_180());
+            break;
+            // default:
+            // std::unreachable();
+    }
+}
+
+// warning! if there is a piece in the hold and the current piece is empty, we dont use the hold
+template <game_mode Mode, std::size_t Preview>
+std::vector<Piece> BasicGame<Mode, Preview>::get_possible_piece_placements() const {
+    // we exausted the queue
+    std::vector<Piece> valid_pieces; 
+    if (current_piece.type == PieceType::Empty) {
+        return valid_pieces;
+    }
+
+    PieceType holdType = hold.has_value() ? hold.value() : queue.front();
+    visit_kicks_180([&]<const KickTable180* Kicks180>() {
+        valid_pieces = Shaktris::MoveGen::Smeared::god_movegen<Kicks180>(board, current_piece.type);
+
+        if (holdType != PieceType::Empty && holdType != current_piece.type) {
+            std::vector<Piece> hold_pieces = Shaktris::MoveGen::Smeared::god_movegen<Kicks180>(board, holdType);
+            valid_pieces.reserve(valid_pieces.size() + hold_pieces.size());
+            for (auto& piece : hold_pieces) {
+                valid_pieces.emplace_back(piece);
+            }
+        }
+    });
+
+    return valid_pieces;
+}
+
+template <game_mode Mode, std::size_t Preview>
+void BasicGame<Mode, Preview>::get_possible_placements(std::vector<Placement>& out) const {
+    if (current_piece.type == PieceType::Empty) {
+        return;
+    }
+
+    PieceType holdType = hold.has_value() ? hold.value() : queue.front();
+    visit_kicks_180([&]<const KickTable180* Kicks180>() {
+        Shaktris::MoveGen::Smeared::god_movegen<Kicks180>(board, current_piece.type, out);
+
+        if (holdType != PieceType::Empty && holdType != current_piece.type) {
+            Shaktris::MoveGen::Smeared::god_movegen<Kicks180>(board, holdType, out);
+        }
+    });
+}
+
+template <game_mode Mode, std::size_t Preview>
+u64 BasicGame<Mode, Preview>::hash() const {
+    u64 h = 0;
+    for (size_t x = 0; x < Board::width; x += 2) {
+        h = hash_combine(h, u64(board.board[x]) | (u64(board.board[x + 1]) << 32));
+    }
+
+    h = hash_combine(h, queue.raw());
 
-    // make a variant thats points callable
-    std::variant<TetrioS1, Botris> mode;
+    u64 counters = u64(b2b) | (u64(combo) << 16) | (u64(garbage_meter) << 32) | (u64(mode_index()) << 40);
+    counters |= static_cast<u64>(current_piece.type) << 48;
+    counters |= static_cast<u64>(hold.has_value() ? hold.value() : PieceType::PieceTypes_N) << 52;
+    return hash_combine(h, counters);
+}
 
-};
\ No newline at end of file
+// the common instantiations are compiled once in Game.cpp
+extern template class BasicGame<GameModes>;
+extern template class BasicGame<TetrioS1>;
+extern template class BasicGame<Botris>;
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <variant>
+
+#include "Board.hpp"
+#include "Game.hpp"
+#include "ShaktrisConstants.hpp"
+
+// Game packed into a single cache line, for search nodes and big arrays of games
+// the current piece is stored as its type only, Game always keeps it at spawn between turns
+struct alignas(64) GameState {
+    static constexpr int piece_bits = 3;
+    static constexpr u64 piece_mask = (1 << piece_bits) - 1;
+
+    static constexpr int current_shift = 0;
+    static constexpr int hold_shift = current_shift + piece_bits;
+    static constexpr int has_hold_shift = hold_shift + piece_bits;
+    static constexpr int queue_shift = has_hold_shift + 1;
+
+    static_assert(queue_shift + piece_bits * QUEUE_SIZE <= 64, "queue does not fit in the packed pieces");
+
+    Board board;
+    // current | hold | has hold | queue[0] | queue[1] ... three bits per piece
+    u64 pieces;
+    u16 b2b;
+    u16 combo;
+    // TetrioS1 combo and b2b chain power, zero for modes without them
+    u16 combo_power;
+    u16 btb_power;
+    u8 garbage_meter;
+    // index of the mode inside GameModes
+    u8 mode;
+
+    constexpr PieceType current() const {
+        return static_cast<PieceType>((pieces >> current_shift) & piece_mask);
+    }
+
+    constexpr std::optional<PieceType> hold() const {
+        if (!((pieces >> has_hold_shift) & 1))
+            return std::nullopt;
+        return static_cast<PieceType>((pieces >> hold_shift) & piece_mask);
+    }
+
+    constexpr PieceType queue(std::size_t i) const {
+        return static_cast<PieceType>((pieces >> (queue_shift + piece_bits * i)) & piece_mask);
+    }
+
+    bool operator==(const GameState& other) const = default;
+
+    template <game_mode Mode, std::size_t Preview>
+    static GameState from(const BasicGame<Mode, Preview>& game) {
+        static_assert(queue_shift + piece_bits * Preview <= 64, "queue does not fit in the packed pieces");
+
+        GameState state{};
+        state.board = game.board;
+
+        u64 pieces = static_cast<u64>(game.current_piece.type) << current_shift;
+        if (game.hold.has_value()) {
+            pieces |= static_cast<u64>(game.hold.value()) << hold_shift;
+            pieces |= u64(1) << has_hold_shift;
+        }
+        // same three bit layout as PieceQueue
+        pieces |= game.queue.raw() << queue_shift;
+        state.pieces = pieces;
+
+        state.b2b = game.b2b;
+        state.combo = game.combo;
+        state.garbage_meter = game.garbage_meter;
+        state.mode = static_cast<u8>(game.mode_index());
+
+        const TetrioS1* tetrio = nullptr;
+        if constexpr (std::same_as<Mode, GameModes>)
+            tetrio = std::get_if<TetrioS1>(&game.mode);
+        else if constexpr (std::same_as<Mode, TetrioS1>)
+            tetrio = &game.mode;
+        if (tetrio) {
+            state.combo_power = tetrio->currentcombopower;
+            state.btb_power = tetrio->currentbtbchainpower;
+        }
+
+        return state;
+    }
+
+    // a state saved from a different fixed mode keeps that mode's counters but not its mode
+    template <game_mode Mode = GameModes, std::size_t Preview = QUEUE_SIZE>
+    BasicGame<Mode, Preview> to_game() const {
+        static_assert(queue_shift + piece_bits * Preview <= 64, "queue does not fit in the packed pieces");
+
+        BasicGame<Mode, Preview> game;
+        game.board = board;
+        game.current_piece = current();
+        game.hold = hold();
+        game.queue = PieceQueue<Preview>::from_raw(pieces >> queue_shift);
+
+        game.b2b = b2b;
+        game.combo = combo;
+        game.garbage_meter = garbage_meter;
+
+        TetrioS1 tetrio;
+        tetrio.currentcombopower = combo_power;
+        tetrio.currentbtbchainpower = btb_power;
+
+        if constexpr (std::same_as<Mode, GameModes>) {
+            if (mode == mode_index<TetrioS1>())
+                game.mode = tetrio;
+            else
+                game.mode = Botris();
+        }
+        else if constexpr (std::same_as<Mode, TetrioS1>) {
+            game.mode = tetrio;
+        }
+
+        return game;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<GameState>, "GameState should copy with a memcpy");
+static_assert(sizeof(GameState) <= 64, "GameState should fit in a cache line");
@@ -16,6 +16,7 @@
 
 #include "Board.hpp"
 #include "Piece.hpp"
+#include "Placement.hpp"
 #include "RotationSystems.hpp"
 #include "ShaktrisConstants.hpp"
 #include "Utility.hpp"
@@ -308,7 +309,8 @@ namespace Shaktris {
 
 
             // movegen for a non convex board with free movement at the top
-            inline std::vector<Piece> movegen(const rotation_function rot_func, const Board& board, PieceType piece_type) {
+            // 180 rotations are tried too when given a kick table for them
+            inline std::vector<Piece> movegen(const rotation_function rot_func, const Board& board, PieceType piece_type, const KickTable180* kicks_180 = nullptr) {
                 std::vector<Piece> valid_moves;
 
                 bool convex = board.surface_convex();
@@ -359,6 +361,12 @@ namespace Shaktris {
                             new_piece = piece;
                             rot_func(board, new_piece, TurnDirection::Right);
                             next_nodes.emplace_back(new_piece);
+
+                            if (kicks_180) {
+                                new_piece = piece;
+                                srs_rotate_180(board, new_piece, *kicks_180);
+                                next_nodes.emplace_back(new_piece);
+                            }
                         }
 
                         new_piece = piece;
@@ -419,16 +427,15 @@ namespace Shaktris {
                 // shift both left and right
                 inline SmearedBoard shift() const {
                     SmearedBoard ret = *this;
-                    // shift each board to the direction
-                    for (auto& board : ret.boards) {
-
-                        board.board[1] |= board.board[0];
-                        board.board[board.board.size() - 2] |= board.board[board.board.size() - 1];
-
-                        for (size_t i = 1; i < board.board.size() - 1; ++i)
-                        {
-                            board.board[i - 1] |= board.board[i];
-                            board.board[i + 1] |= board.board[i];
+                    // one column each way, read from the unshifted board so nothing travels further than that
+                    for (size_t b_index = 0; b_index < boards.size(); ++b_index) {
+                        const auto& board = boards[b_index].board;
+                        auto& shifted = ret.boards[b_index].board;
+                        for (size_t i = 0; i < board.size(); ++i) {
+                            if (i > 0)
+                                shifted[i] |= board[i - 1];
+                            if (i + 1 < board.size())
+                                shifted[i] |= board[i + 1];
                         }
                     }
 
@@ -602,6 +609,117 @@ namespace Shaktris {
                     return ret;
                 }
 
+                // rotate_srs with what each kick needs worked out once, for callers that turn on the same board over and over
+                // fits[(from * 2 + left) * srs_kicks + i] has the spots of rotation from that kick i of that turn takes into a free spot,
+                // filled the first time a turn needs it, like KickMasks180 below
+                struct KickMasksSrs {
+                    std::array<Board, RotationDirections_N * 2 * srs_kicks> fits;
+                    u64 ready = 0;
+                };
+
+                // both quarter turns of every piece, each one takes the first kick that fits
+                // only the turned pieces come back, and all of them fit already
+                inline SmearedBoard rotate_srs(const SmearedBoard& pieces, PieceType type, KickMasksSrs& masks) const {
+                    const auto& offsets = type == PieceType::I ? piece_offsets_I : (type == PieceType::O ? piece_offsets_O : piece_offsets_JLSTZ);
+                    SmearedBoard ret{};
+
+                    for (size_t from = 0; from < 4; ++from) {
+                        column_t any = 0;
+                        for (size_t x = 0; x < Board::width; x++)
+                            any |= pieces.boards[from].board[x];
+                        if (!any)
+                            continue;
+
+                        for (size_t left_turn = 0; left_turn < 2; ++left_turn) {
+                            const size_t to = (from + (left_turn ? 3 : 1)) % 4;
+                            Board left = pieces.boards[from];
+                            column_t rest = any;
+                            for (size_t kick_i = 0; rest && kick_i < srs_kicks; kick_i++) {
+                                const Coord kick((i8)(offsets[from][kick_i].x - offsets[to][kick_i].x), (i8)(offsets[from][kick_i].y - offsets[to][kick_i].y));
+                                const size_t slot = (from * 2 + left_turn) * srs_kicks + kick_i;
+                                Board& fits = masks.fits[slot];
+                                if (!(masks.ready & (u64(1) << slot))) {
+                                    for (size_t x = 0; x < Board::width; x++)
+                                        fits.board[x] = ~boards[to].board[x];
+                                    fits.offset(Coord((i8)-kick.x, (i8)-kick.y));
+                                    masks.ready |= u64(1) << slot;
+                                }
+
+                                Board turned;
+                                column_t moved = 0;
+                                rest = 0;
+                                for (size_t x = 0; x < Board::width; x++) {
+                                    turned.board[x] = left.board[x] & fits.board[x];
+                                    left.board[x] &= ~fits.board[x];
+                                    moved |= turned.board[x];
+                                    rest |= left.board[x];
+                                }
+                                if (moved) {
+                                    turned.offset(kick);
+                                    ret.boards[to] |= turned;
+                                }
+                            }
+                        }
+                    }
+
+                    return ret;
+                }
+
+                // for a half turn, the spots of rotation from that kick i turns into a free spot, whatever the kicks before it do
+                // a half turn only swaps north with south and east with west, and what fits depends on the board alone,
+                // so each one is worked out the first time rotate_180 needs it and reused for the rest of the movegen
+                struct KickMasks180 {
+                    std::array<Board, RotationDirections_N * max_kicks_180> fits;
+                    u32 ready = 0;
+                };
+
+                inline const Board& kick_fits_180(PieceType type, const KickTable180& kicks, KickMasks180& masks, size_t from, size_t kick_i) const {
+                    const size_t slot = from * max_kicks_180 + kick_i;
+                    Board& fits = masks.fits[slot];
+                    if (!(masks.ready & (u32(1) << slot))) {
+                        const size_t to = (from + 2) % 4;
+                        const Coord kick = kick_180(kicks, type, from, kick_i);
+                        // free spots after turning, brought back to where they turn from, off the board stays blocked
+                        for (size_t x = 0; x < Board::width; x++)
+                            fits.board[x] = ~boards[to].board[x];
+                        fits.offset(Coord((i8)-kick.x, (i8)-kick.y));
+                        masks.ready |= u32(1) << slot;
+                    }
+                    return fits;
+                }
+
+                // rotate_srs for a half turn, each piece takes the first kick of the table that fits
+                // only the turned pieces come back, and all of them fit already
+                inline SmearedBoard rotate_180(const SmearedBoard& pieces, PieceType type, const KickTable180& kicks, KickMasks180& masks) const {
+                    SmearedBoard ret{};
+
+                    for (size_t from = 0; from < 4; ++from) {
+                        const size_t to = (from + 2) % 4;
+                        Board left = pieces.boards[from];
+                        column_t rest = 0;
+                        for (size_t x = 0; x < Board::width; x++)
+                            rest |= left.board[x];
+                        for (size_t kick_i = 0; rest && kick_i < kicks.kicks; kick_i++) {
+                            const Board& fits = kick_fits_180(type, kicks, masks, from, kick_i);
+                            Board turned;
+                            column_t any = 0;
+                            rest = 0;
+                            for (size_t x = 0; x < Board::width; x++) {
+                                turned.board[x] = left.board[x] & fits.board[x];
+                                left.board[x] &= ~fits.board[x];
+                                any |= turned.board[x];
+                                rest |= left.board[x];
+                            }
+                            if (any) {
+                                turned.offset(kick_180(kicks, type, from, kick_i));
+                                ret.boards[to] |= turned;
+                            }
+                        }
+                    }
+
+                    return ret;
+                }
+
 
                 inline void rotate_right() {
                     if (boards.empty()) return; // Handle empty array
@@ -731,6 +849,28 @@ namespace Shaktris {
                 u8 rot;
             };
 
+            // bfs frontier on the stack, every state gets queued at most once so it can never overflow
+            struct SmearedFrontier {
+                std::array<SmearedPiece, 32 * Board::width * 4> nodes;
+                size_t size = 0;
+
+                void push_back(const SmearedPiece& piece) {
+                    nodes[size++] = piece;
+                }
+                void clear() {
+                    size = 0;
+                }
+                bool empty() const {
+                    return size == 0;
+                }
+                const SmearedPiece* begin() const {
+                    return nodes.data();
+                }
+                const SmearedPiece* end() const {
+                    return nodes.data() + size;
+                }
+            };
+
             inline void deduplicate(SmearedBoard& dedup, PieceType type) {
                 if (type == PieceType::Z || type == PieceType::S || type == PieceType::I) {
                     dedup.boards[2].zero();
@@ -756,6 +896,21 @@ namespace Shaktris {
                 return ret;
             }
 
+            // same order as moves_to_vec, without building the vector
+            template <class Emit>
+            inline void emit_moves(const SmearedBoard& moves, PieceType type, Emit& emit) {
+                for (size_t b_index = 0; b_index < moves.boards.size(); ++b_index) {
+                    for (size_t x = 0; x < Board::width; x++) {
+                        auto col = moves.boards[b_index].board[x];
+                        while (auto height = (sizeof(column_t) * CHAR_BIT) - std::countl_zero(col)) {
+                            emit(Placement(type, (RotationDirection)b_index, Coord(x, height - 1)));
+
+                            col &= ~(1 << (height - 1)); // clear the bit
+                        }
+                    }
+                }
+            }
+
             inline std::vector<SmearedPiece> smeared_moves_to_vec(const SmearedBoard& moves, PieceType type) {
                 std::vector<SmearedPiece> ret;
                 ret.reserve(150);
@@ -774,7 +929,9 @@ namespace Shaktris {
                 return ret;
             }
 
-            inline SmearedBoard smear(const Board& board, PieceType type) {
+            // the piece is a template argument so the mino offsets are constants and every shift goes one way
+            template <PieceType type>
+            inline SmearedBoard smear(const Board& board) {
                 SmearedBoard ret{};
                 std::array<column_t, 14> thick_board;
                 // initialize the first and last two with ~0
@@ -791,11 +948,8 @@ namespace Shaktris {
                 for (size_t rot = 0; rot < 4; rot++) {
                     for (const Coord& mino : rot_piece_def[static_cast<size_t>(type)][rot]) {
                         for (size_t x = 0; x < Board::width; x++) {
-                            column_t c = thick_board[2 + x + mino.x];
-                            bool cond = (mino.y < 0);
-                            c = ((!cond) * (c >> mino.y)) | (cond * ~(~c << -mino.y));
-
-                            ret.boards[rot].board[x] |= c;
+                            const column_t c = thick_board[2 + x + mino.x];
+                            ret.boards[rot].board[x] |= mino.y < 0 ? ~(~c << -mino.y) : c >> mino.y;
                         }
                     }
                 }
@@ -803,6 +957,27 @@ namespace Shaktris {
                 return ret;
             }
 
+            inline SmearedBoard smear(const Board& board, PieceType type) {
+                switch (type) {
+                case PieceType::S:
+                    return smear<PieceType::S>(board);
+                case PieceType::Z:
+                    return smear<PieceType::Z>(board);
+                case PieceType::J:
+                    return smear<PieceType::J>(board);
+                case PieceType::L:
+                    return smear<PieceType::L>(board);
+                case PieceType::T:
+                    return smear<PieceType::T>(board);
+                case PieceType::O:
+                    return smear<PieceType::O>(board);
+                case PieceType::I:
+                    return smear<PieceType::I>(board);
+                default:
+                    return smear<PieceType::Empty>(board);
+                }
+            }
+
             // movegen for only one rotation of the convex movegen
             inline Board partial_convex_movegen(const Board& board, const PieceType type) {
                 Board ret{};
@@ -899,6 +1074,8 @@ namespace Shaktris {
                 return moves_to_vec(flood_new, type);
             }
 
+            // Kicks180 turns on 180 rotations with that table, none without
+            template <const KickTable180* Kicks180 = nullptr>
             inline std::vector<Piece> movegen(const Board& board, PieceType type) {
                 if (board.surface_convex()) {
                     return moves_to_vec(convex_movegen(board, type), type);
@@ -907,6 +1084,8 @@ namespace Shaktris {
                 SmearedBoard visited{};
                 SmearedBoard open_nodes{};
                 SmearedBoard next_nodes{};
+                SmearedBoard::KickMasks180 kick_masks;
+                SmearedBoard unturned{};
 
                 open_nodes.boards[0].board[4/* x */] = 1 << 19/* y */; // set north piece rotation to the piece position
 
@@ -932,6 +1111,9 @@ namespace Shaktris {
                         next_nodes |= tmp_pieces;
                     }
 
+                    if constexpr (Kicks180 != nullptr)
+                        unturned |= open_nodes;
+
                     { // already taken care of by smear drop
                         SmearedBoard smeared_pieces = smeared_board.smear_drop(open_nodes);
                         // smeared_board.non_collides(smeared_pieces);
@@ -942,6 +1124,17 @@ namespace Shaktris {
 
                     std::swap(open_nodes, next_nodes);
                     next_nodes = {};
+
+                    // 180s wait until nothing else is left to reach and then turn everything at once,
+                    // the flood ends up the same and most boards get nothing new out of them, so that is usually the last step
+                    if constexpr (Kicks180 != nullptr) {
+                        if (open_nodes.empty()) {
+                            open_nodes = smeared_board.rotate_180(unturned, type, *Kicks180, kick_masks);
+                            visited.non_collides(open_nodes);
+                            visited |= open_nodes;
+                            unturned = {};
+                        }
+                    }
                 }
 
                 return moves_to_vec(smeared_board.grounded(visited), type);
@@ -979,7 +1172,7 @@ namespace Shaktris {
                     tmp.position.y += offset.y;
                     tmp.rot = new_rot;
 
-                    if (tmp.position.x >= 0 && tmp.position.x < Board::width && tmp.position.y >= 0) {
+                    if (tmp.position.x >= 0 && tmp.position.x < Board::width && tmp.position.y >= 0 && tmp.position.y < (i8)Board::height) {
                         auto& col = s_board.boards[static_cast<size_t>(new_rot)].board[static_cast<size_t>(tmp.position.x)];
                         if (!(col & (column_t(1) << tmp.position.y))) {
 							worked[i] = true;
@@ -995,7 +1188,7 @@ namespace Shaktris {
                             (i8)(*prev_offsets)[p.rot][i].x - (i8)(*offsets)[static_cast<size_t>(new_rot)][i].x,
                             (i8)(*prev_offsets)[p.rot][i].y - (i8)(*offsets)[static_cast<size_t>(new_rot)][i].y);
 
-                        SmearedPiece ret = p;
+                        ret = p;
                         ret.position.x += offset.x;
                         ret.position.y += offset.y;
                         ret.rot = new_rot;
@@ -1004,119 +1197,159 @@ namespace Shaktris {
                 p = ret;
             }
 
-            inline std::vector<Piece> god_movegen(const Board& board, const PieceType type) {
-                std::vector<Piece> ret;
-                ret.reserve(150);
-                if (board.surface_convex() && board.is_low()) {
-                    ret = moves_to_vec(convex_movegen(board, type), type);
-                    return ret;
+            // srs_rotate_180 on the smeared board, the piece is left as it is if no kick fits
+            inline void srs_180(const SmearedBoard& s_board, SmearedPiece& p, PieceType type, const KickTable180& kicks) {
+                const u8 new_rot = (p.rot + 2) % 4;
+                for (size_t i = 0; i < kicks.kicks; ++i) {
+                    const Coord offset = kick_180(kicks, type, p.rot, i);
+                    const i8 x = (i8)(p.position.x + offset.x);
+                    const i8 y = (i8)(p.position.y + offset.y);
+                    if (x < 0 || x >= (i8)Board::width || y < 0 || y >= (i8)Board::height)
+                        continue;
+                    if (!(s_board.boards[new_rot].board[static_cast<size_t>(x)] & (column_t(1) << y))) {
+                        p = { Coord(x, y), new_rot };
+                        return;
+                    }
                 }
-                const SmearedBoard s_board = smear(board, type);
-                std::vector<SmearedPiece> open_nodes;
-                open_nodes.reserve(150);
-                std::vector<SmearedPiece> next_nodes;
-                next_nodes.reserve(150);
-                std::bitset<32 * 10 * 4> visited;
-                std::bitset<32 * 10 * 4> returned;
-                auto is_immobile = [](const SmearedBoard& board, const SmearedPiece& piece) {
-                    bool left = false;
-                    bool right = false;
-                    bool down = false;
-                    bool up = false;
-                    if (piece.position.x == 0)
+            }
+
+            // a piece that can not move left, right, down or up, what god_movegen counts as a spin
+            inline bool is_immobile(const SmearedBoard& board, const SmearedPiece& piece) {
+                bool left = false;
+                bool right = false;
+                bool down = false;
+                bool up = false;
+                if (piece.position.x == 0)
+                    left = true;
+                else {
+                    const auto col = board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x - 1)];
+                    if (col & (1 << piece.position.y))
                         left = true;
-                    else {
-                        const auto col = board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x - 1)];
-                        if (col & (1 << piece.position.y))
-                            left = true;
-                    }
+                }
 
-                    if (piece.position.x == Board::width - 1)
+                if (piece.position.x == Board::width - 1)
+                    right = true;
+                else {
+                    const auto col = board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x + 1)];
+                    if (col & (1 << piece.position.y))
                         right = true;
-                    else {
-                        const auto col = board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x + 1)];
-                        if (col & (1 << piece.position.y))
-                            right = true;
-                    }
+                }
 
-                    if (piece.position.y == 0)
+                if (piece.position.y == 0)
+                    down = true;
+                else {
+                    const auto col = board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x)];
+                    if (col & (1 << (piece.position.y - 1)))
                         down = true;
-                    else {
-                        const auto col = board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x)];
-                        if (col & (1 << (piece.position.y - 1)))
-                            down = true;
-                    }
+                }
 
-                    if (piece.position.y == Board::height - 1)
+                if (piece.position.y == Board::height - 1)
+                    up = true;
+                else {
+                    const auto col = board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x)];
+                    if (col & (1 << (piece.position.y + 1)))
                         up = true;
-                    else {
-                        const auto col = board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x)];
-                        if (col & (1 << (piece.position.y + 1)))
-                            up = true;
-                    }
+                }
 
-                    return left & right & down & up;
-                };
-                // thanks Citrus for this piece of code!
-                // https://github.com/citrus610/tetris-movegen/blob/bd6ff34145c8898a6365bdc603706e7f318430e5/src/piece.cpp#L25
-                auto cannonicalize = [](const SmearedPiece& piece, PieceType type) {
-					SmearedPiece ret = piece;
-                    switch (type) {
-                    case PieceType::I:
-                        switch (piece.rot) {
-                        case 0:
-                            break;
-                        case 1:
-                            break;
-                        case 2:
-                            ret.rot = 0;
-                            ret.position.x--;
-                            break;
-                        case 3:
-                            ret.rot = 1;
-                            ret.position.y++;
-                            break;
-                        }
+                return left & right & down & up;
+            }
+
+            // I, S and Z cover the same cells in their south and west states as in north and east, god_movegen only gives the latter
+            // and O covers the same cells in every state as in north
+            // thanks Citrus for this piece of code!
+            // https://github.com/citrus610/tetris-movegen/blob/bd6ff34145c8898a6365bdc603706e7f318430e5/src/piece.cpp#L25
+            inline SmearedPiece cannonicalize(const SmearedPiece& piece, PieceType type) {
+                SmearedPiece ret = piece;
+                switch (type) {
+                case PieceType::I:
+                    switch (piece.rot) {
+                    case 2:
+                        ret.rot = 0;
+                        ret.position.x--;
+                        break;
+                    case 3:
+                        ret.rot = 1;
+                        ret.position.y++;
                         break;
-					case PieceType::S:
-						switch (piece.rot) {
-						case 0:
-							break;
-						case 1:
-							break;
-						case 2:
-                            ret.rot = 0;
-                            ret.position.y--;
-							break;
-						case 3:
-                            ret.position.x++;
-                            ret.rot = 1;
-							break;
-						}
-						break;
-					case PieceType::Z:
-						switch (piece.rot) {
-						case 0:
-							break;
-						case 1:
-							break;
-						case 2:
-							ret.rot = 0;
-							ret.position.y--;
-							break;
-						case 3:
-							ret.position.x--;
-							ret.rot = 1;
-							break;
-						}
-						break;
-					default:
-						break;
                     }
+                    break;
+                case PieceType::S:
+                case PieceType::Z:
+                    switch (piece.rot) {
+                    case 2:
+                        ret.rot = 0;
+                        ret.position.y--;
+                        break;
+                    case 3:
+                        ret.position.x--;
+                        ret.rot = 1;
+                        break;
+                    }
+                    break;
+                // god_movegen never turns an O, but a game can, every state covers the cells of north somewhere
+                case PieceType::O:
+                    ret.rot = 0;
+                    if (piece.rot == 1 || piece.rot == 2)
+                        ret.position.y--;
+                    if (piece.rot == 2 || piece.rot == 3)
+                        ret.position.x--;
+                    break;
+                default:
+                    break;
+                }
 
-					return ret;
-			    };
+                return ret;
+            }
 
+            // the I, S and Z twins of a whole set moved onto north and east, what cannonicalize does to one piece
+            inline void fold(SmearedBoard& moves, PieceType type) {
+                if (type != PieceType::I && type != PieceType::S && type != PieceType::Z)
+                    return;
+                auto& north = moves.boards[0].board;
+                auto& east = moves.boards[1].board;
+                const auto& south = moves.boards[2].board;
+                const auto& west = moves.boards[3].board;
+                for (size_t x = 0; x < Board::width; ++x) {
+                    if (type == PieceType::I) {
+                        if (x > 0)
+                            north[x - 1] |= south[x];
+                        east[x] |= west[x] << 1;
+                    }
+                    else {
+                        north[x] |= south[x] >> 1;
+                        if (x > 0)
+                            east[x - 1] |= west[x];
+                    }
+                }
+                moves.boards[2].zero();
+                moves.boards[3].zero();
+            }
+
+            // calls emit(Placement) once for every reachable placement
+            // Kicks180 turns on 180 rotations with that table, none without
+            template <const KickTable180* Kicks180 = nullptr, class Emit>
+            inline void god_movegen(const Board& board, const PieceType type, Emit&& emit) {
+                if (board.surface_convex() && board.is_low()) {
+                    emit_moves(convex_movegen(board, type), type, emit);
+                    return;
+                }
+                const SmearedBoard s_board = smear(board, type);
+                std::array<SmearedFrontier, 2> frontiers;
+                SmearedFrontier* open_nodes = &frontiers[0];
+                SmearedFrontier* next_nodes = &frontiers[1];
+                // set when a state is first queued, so nothing is queued (or expanded) twice
+                std::bitset<32 * 10 * 4> visited;
+                std::bitset<32 * 10 * 4> returned;
+                auto to_iter = [](auto x, auto y, auto r) {
+                    return y + x * 32 + r * 32 * 10;
+                };
+                auto push = [&](SmearedFrontier& nodes, const SmearedPiece& piece) {
+                    const size_t iter = to_iter(piece.position.x, piece.position.y, piece.rot);
+                    if (visited[iter])
+                        return;
+                    visited[iter] = true;
+                    nodes.push_back(piece);
+                };
                 if (s_board.convex(PieceType::O == type)) {
                     SmearedBoard moves{};
                     for (size_t i = 0; i < 4; ++i) {
@@ -1133,8 +1366,8 @@ namespace Shaktris {
                         }
                     }
 
-                    ret = moves_to_vec(moves, type);
-                    return ret;
+                    emit_moves(moves, type, emit);
+                    return;
                 } else if (board.is_low()) {
                     SmearedBoard moves{};
                     for (int rot = 0; rot < 4; ++rot) {
@@ -1152,33 +1385,29 @@ namespace Shaktris {
                             break;
                         }
                     }
-                    auto full_pieces = moves_to_vec(moves, type);
+                    for (size_t rot = 0; rot < moves.boards.size(); ++rot) {
+                        for (size_t x = 0; x < Board::width; x++) {
+                            auto col = moves.boards[rot].board[x];
+                            while (auto height = (sizeof(column_t) * CHAR_BIT) - std::countl_zero(col)) {
+                                push(*open_nodes, SmearedPiece{ Coord(x, height - 1), (u8)rot });
 
-                    for(auto& piece : full_pieces) {
-                        open_nodes.push_back(SmearedPiece{piece.position, (u8)piece.rotation});
+                                col &= ~(1 << (height - 1)); // clear the bit
+                            }
+                        }
                     }
                 } else {
-                    open_nodes.push_back({Coord((i8)4, (i8)19), 0});
+                    push(*open_nodes, {Coord((i8)4, (i8)19), 0});
                 }
 
                 while (true) {
-                    for (const auto &piece : open_nodes) {
-                        auto to_iter = [](auto x, auto y, auto r) {
-                            return y + x * 32 + r * 32 * 10;
-                        };
-                        size_t iter = to_iter(piece.position.x, piece.position.y, piece.rot);
-
-                        if (visited[iter])
-                            continue;
-                        visited[iter] = true;
+                    for (const auto &piece : *open_nodes) {
 
                         // shift left
                         if (piece.position.x > 0) {
                             const auto col = s_board.boards[static_cast<size_t>(piece.rot)].board[static_cast<size_t>(piece.position.x - 1)];
                             SmearedPiece new_piece = { Coord(piece.position.x - 1, piece.position.y), piece.rot };
-                            if (!(col & (1 << piece.position.y)) &&
-                                !visited[to_iter(new_piece.position.x, new_piece.position.y, piece.rot)])
-                                    next_nodes.push_back(new_piece);
+                            if (!(col & (1 << piece.position.y)))
+                                push(*next_nodes, new_piece);
                         }
 
                         // shift right
@@ -1187,9 +1416,8 @@ namespace Shaktris {
                             SmearedPiece new_piece = { Coord(piece.position.x + 1, piece.position.y), piece.rot };
 							// if its not colliding with the board
 							// if its not in the visited set push it to the next nodes
-                            if (!(col & (1 << piece.position.y)) && 
-                                !visited[to_iter(new_piece.position.x, new_piece.position.y, piece.rot)])
-                                    next_nodes.push_back(new_piece);
+                            if (!(col & (1 << piece.position.y)))
+                                push(*next_nodes, new_piece);
                         }
 
                         // sonic drop
@@ -1201,8 +1429,7 @@ namespace Shaktris {
                             const auto height = ((int)sizeof(column_t) * 8) - std::countl_zero(col);
                             // const auto height = std::clamp(piece.position.y - 1,0,32);
                             SmearedPiece new_piece = { Coord(piece.position.x, height), piece.rot };
-							if (!visited[to_iter(new_piece.position.x, new_piece.position.y, piece.rot)])
-								next_nodes.push_back(new_piece);
+                            push(*next_nodes, new_piece);
                         }
 
                         // rotate srs
@@ -1211,13 +1438,19 @@ namespace Shaktris {
 
                             srs<TurnDirection::Right>(s_board, next_piece, type);
 
-                            next_nodes.push_back({next_piece});
+                            push(*next_nodes, next_piece);
 
                             next_piece = piece;
 
                             srs<TurnDirection::Left>(s_board, next_piece, type);
 
-                            next_nodes.push_back({next_piece});
+                            push(*next_nodes, next_piece);
+
+                            if constexpr (Kicks180 != nullptr) {
+                                next_piece = piece;
+                                srs_180(s_board, next_piece, type, *Kicks180);
+                                push(*next_nodes, next_piece);
+                            }
                         }
 
                         // if is grounded push to ret
@@ -1226,35 +1459,224 @@ namespace Shaktris {
 
                             if ((piece.position.y == 0) || (col & (1 << (piece.position.y - 1)))) {
 								SmearedPiece new_piece = cannonicalize(piece, type);
-                                Piece p = Piece(type, (RotationDirection)new_piece.rot, new_piece.position, spinType::null);
 
 								auto iter = to_iter(new_piece.position.x, new_piece.position.y, new_piece.rot);
                                 // does not contain
                                 if (!returned[iter]) {
 									returned[iter] = true;
                                     bool is_immobile_piece =  is_immobile(s_board, piece);
-                                    if (is_immobile_piece)
-                                        p.spin = spinType::normal;
-                                    ret.push_back(p);
+                                    emit(Placement(type, (RotationDirection)new_piece.rot, new_piece.position,
+                                        is_immobile_piece ? spinType::normal : spinType::null));
                                 }
                             }
                         }
                     }
                     std::swap(open_nodes, next_nodes);
-                    next_nodes.clear();
+                    next_nodes->clear();
 
-					if (open_nodes.empty())
+					if (open_nodes->empty())
 						break;
                 }
 
                 // go through all pieces and check if they are grounded
 
                 // check which pieces are immobile all spin
+            }
 
-
+            template <const KickTable180* Kicks180 = nullptr>
+            inline std::vector<Piece> god_movegen(const Board& board, const PieceType type) {
+                std::vector<Piece> ret;
+                ret.reserve(150);
+                god_movegen<Kicks180>(board, type, [&](Placement placement) { ret.push_back(placement.to_piece()); });
                 return ret;
             }
+
+            // packed output, appends to out so one vector can collect several pieces worth of moves
+            template <const KickTable180* Kicks180 = nullptr>
+            inline void god_movegen(const Board& board, const PieceType type, std::vector<Placement>& out) {
+                god_movegen<Kicks180>(board, type, [&](Placement placement) { out.push_back(placement); });
+            }
         }; // namespace Smeared
+
+        // placements reachable by only rotating and shifting at spawn height and then hard dropping, no soft drops and no tucks
+        // works on any board: every rotation is turned into at spawn, srs kicks included (south is two clockwise turns),
+        // then slid along its row as far as the smeared board lets it, then dropped
+        // the placements come out like god_movegen's, south and west of I, S and Z folded into north and east and never spins
+        namespace HardDrop {
+            using Smeared::SmearedBoard;
+            using Smeared::SmearedPiece;
+
+            // where every rotation starts its sweep, rot is left at 0xff for one the piece can not turn into
+            struct Starts {
+                std::array<SmearedPiece, RotationDirections_N> pieces;
+                // free cells of each rotation's row, one bit per column
+                std::array<u32, RotationDirections_N> runs{};
+            };
+
+            // srs with the kicks tried in order, stopping at the first that fits, the start is nearly always free
+            inline bool turn(const SmearedBoard& s_board, SmearedPiece& piece, PieceType type, u8 to) {
+                const auto& offsets = type == PieceType::I ? piece_offsets_I : piece_offsets_JLSTZ;
+                for (size_t i = 0; i < srs_kicks; ++i) {
+                    const i8 x = (i8)(piece.position.x + offsets[piece.rot][i].x - offsets[to][i].x);
+                    const i8 y = (i8)(piece.position.y + offsets[piece.rot][i].y - offsets[to][i].y);
+                    if (x < 0 || x >= (i8)Board::width || y < 0 || y >= (i8)Board::height)
+                        continue;
+                    if (!(s_board.boards[to].board[static_cast<size_t>(x)] & (column_t(1) << y))) {
+                        piece = { Coord(x, y), to };
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            inline Starts starts(const SmearedBoard& s_board, PieceType type) {
+                Starts ret;
+                for (SmearedPiece& piece : ret.pieces)
+                    piece = { Coord(0, 0), 0xff };
+
+                const SmearedPiece spawn{ Coord((i8)(Board::width / 2 - 1), piece_spawn_height), 0 };
+                if (s_board.boards[0].board[static_cast<size_t>(spawn.position.x)] & (column_t(1) << spawn.position.y))
+                    return ret;
+                ret.pieces[0] = spawn;
+                // O covers the same cells in every rotation
+                if (type == PieceType::O)
+                    return ret;
+
+                SmearedPiece turned = spawn;
+                if (turn(s_board, turned, type, 1)) {
+                    ret.pieces[1] = turned;
+                    if (turn(s_board, turned, type, 2))
+                        ret.pieces[2] = turned;
+                }
+                turned = spawn;
+                if (turn(s_board, turned, type, 3))
+                    ret.pieces[3] = turned;
+                return ret;
+            }
+
+            // the columns a piece slides to from x, given the free cells of its row
+            inline u32 sweep(u32 free, i8 x) {
+                const u32 start = u32(1) << x;
+                // the carry runs through the free cells to the right of x
+                const u32 up = (free ^ (free + start)) & free;
+                // and the highest blocked cell to the left of x ends the run there
+                const u32 blocked_below = ~free & (start - 1);
+                const u32 down = ((start << 1) - 1) & ~((u32(1) << std::bit_width(blocked_below)) - 1);
+                return up | down;
+            }
+
+            // one bit per landing spot, before folding
+            inline SmearedBoard landings_scalar(const SmearedBoard& s_board, const Starts& starts) {
+                SmearedBoard ret{};
+                for (size_t rot = 0; rot < RotationDirections_N; ++rot) {
+                    const SmearedPiece& piece = starts.pieces[rot];
+                    if (piece.rot == 0xff)
+                        continue;
+                    const auto& cols = s_board.boards[rot].board;
+                    const column_t below = (column_t(1) << piece.position.y) - 1;
+                    u32 free = 0;
+                    for (size_t x = 0; x < Board::width; ++x)
+                        free |= u32(!(cols[x] & (column_t(1) << piece.position.y))) << x;
+                    for (u32 run = sweep(free, piece.position.x); run; run &= run - 1) {
+                        const size_t x = static_cast<size_t>(std::countr_zero(run));
+                        ret.boards[rot].board[x] = column_t(1) << std::bit_width(cols[x] & below);
+                    }
+                }
+                return ret;
+            }
+
+#ifdef __AVX2__
+            // the same with all 40 columns in 5 registers
+            // bit_width comes from the float exponent, exact since nothing below spawn height needs more than 24 bits
+            inline SmearedBoard landings_avx2(const SmearedBoard& s_board, const Starts& starts) {
+                static_assert(sizeof(SmearedBoard) == RotationDirections_N * Board::width * sizeof(column_t), "smeared board is not 40 packed columns");
+                constexpr size_t lanes = RotationDirections_N * Board::width;
+
+                // each rotation's row, spread over the lanes its columns sit in, 0 for the ones that can not be turned into
+                std::array<int, RotationDirections_N> y{};
+                u64 candidates = 0;
+                for (size_t rot = 0; rot < RotationDirections_N; ++rot) {
+                    if (starts.pieces[rot].rot == 0xff)
+                        continue;
+                    y[rot] = starts.pieces[rot].position.y;
+                    candidates |= u64(0x3ff) << (rot * Board::width);
+                }
+                alignas(32) const __m256i ys[lanes / 8] = {
+                    _mm256_set1_epi32(y[0]),
+                    _mm256_setr_epi32(y[0], y[0], y[1], y[1], y[1], y[1], y[1], y[1]),
+                    _mm256_setr_epi32(y[1], y[1], y[1], y[1], y[2], y[2], y[2], y[2]),
+                    _mm256_setr_epi32(y[2], y[2], y[2], y[2], y[2], y[2], y[3], y[3]),
+                    _mm256_set1_epi32(y[3]),
+                };
+
+                const column_t* cols = s_board.boards[0].board.data();
+                const __m256i one = _mm256_set1_epi32(1);
+                const __m256i zero = _mm256_setzero_si256();
+
+                alignas(32) __m256i col[lanes / 8];
+                // free cells of each row, 8 columns at a time
+                u64 free = 0;
+                for (size_t i = 0; i < lanes / 8; ++i) {
+                    col[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cols + i * 8));
+                    const __m256i hit = _mm256_and_si256(_mm256_srlv_epi32(col[i], ys[i]), one);
+                    free |= u64(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(hit, zero)))) << (i * 8);
+                }
+                free &= candidates;
+
+                u64 reached = 0;
+                for (size_t rot = 0; rot < RotationDirections_N; ++rot) {
+                    const SmearedPiece& piece = starts.pieces[rot];
+                    if (piece.rot != 0xff)
+                        reached |= u64(sweep(static_cast<u32>(free >> (rot * Board::width)) & 0x3ff, piece.position.x)) << (rot * Board::width);
+                }
+
+                SmearedBoard ret;
+                column_t* out = ret.boards[0].board.data();
+                const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+                const __m256i bias = _mm256_set1_epi32(126);
+                for (size_t i = 0; i < lanes / 8; ++i) {
+                    const __m256i below = _mm256_and_si256(col[i], _mm256_sub_epi32(_mm256_sllv_epi32(one, ys[i]), one));
+                    const __m256i exponent = _mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(below)), 23);
+                    const __m256i width = _mm256_max_epi32(_mm256_sub_epi32(exponent, bias), zero);
+                    const __m256i selected = _mm256_set1_epi32(static_cast<int>((reached >> (i * 8)) & 0xff));
+                    const __m256i keep = _mm256_cmpeq_epi32(_mm256_and_si256(selected, lane_bits), lane_bits);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i * 8), _mm256_and_si256(_mm256_sllv_epi32(one, width), keep));
+                }
+                return ret;
+            }
+#endif
+
+            // every hard drop placement as one bit per landing spot
+            inline SmearedBoard moves(const SmearedBoard& s_board, PieceType type) {
+                const Starts from = starts(s_board, type);
+#ifdef __AVX2__
+                SmearedBoard ret = landings_avx2(s_board, from);
+#else
+                SmearedBoard ret = landings_scalar(s_board, from);
+#endif
+                Smeared::fold(ret, type);
+                return ret;
+            }
+
+            inline SmearedBoard moves(const Board& board, PieceType type) {
+                return moves(Smeared::smear(board, type), type);
+            }
+
+            // calls emit(Placement) once for every hard drop placement
+            template <class Emit>
+            inline void movegen(const Board& board, PieceType type, Emit&& emit) {
+                Smeared::emit_moves(moves(board, type), type, emit);
+            }
+
+            inline std::vector<Piece> movegen(const Board& board, PieceType type) {
+                return Smeared::moves_to_vec(moves(board, type), type);
+            }
+
+            // packed output, appends to out
+            inline void movegen(const Board& board, PieceType type, std::vector<Placement>& out) {
+                movegen(board, type, [&](Placement placement) { out.push_back(placement); });
+            }
+        }; // namespace HardDrop
     }; // namespace MoveGen
 }; // namespace Shaktris
 
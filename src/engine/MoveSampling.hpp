@@ -0,0 +1,269 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <span>
+
+#include "../util/pext.hpp"
+#include "Board.hpp"
+#include "Game.hpp"
+#include "MoveGen.hpp"
+#include "Placement.hpp"
+#include "ShaktrisConstants.hpp"
+
+namespace Shaktris {
+    namespace MoveGen {
+        namespace Sampling {
+
+            // anything with the getRand of RNG, a number in [0, upper_bound)
+            template <class Rng>
+            concept random_source = requires(Rng rng, u32 upper_bound) {
+                { rng.getRand(upper_bound) } -> std::convertible_to<u32>;
+            };
+
+            // the same placements Smeared::god_movegen gives for one piece, kept as bits instead of a list
+            // moves.boards[rotation].board[x] has bit y set for every placement, spins marks the immobile ones
+            struct PlacementSet {
+                Smeared::SmearedBoard moves{};
+                Smeared::SmearedBoard spins{};
+                PieceType type = PieceType::Empty;
+                u32 count = 0;
+
+                // the rank-th placement in rotation, x, y order
+                Placement select(u32 rank) const {
+                    for (size_t rot = 0; rot < moves.boards.size(); ++rot) {
+                        for (size_t x = 0; x < Board::width; ++x) {
+                            const column_t col = moves.boards[rot].board[x];
+                            const u32 in_column = (u32)std::popcount(col);
+                            if (rank < in_column) {
+                                const column_t bit = pdep(column_t(1) << rank, col);
+                                const i8 y = (i8)std::countr_zero(bit);
+                                const bool spin = spins.boards[rot].board[x] & bit;
+                                return Placement(type, (RotationDirection)rot, Coord((i8)x, y), spin ? spinType::normal : spinType::null);
+                            }
+                            rank -= in_column;
+                        }
+                    }
+                    return Placement();
+                }
+
+                void erase(Placement placement) {
+                    const Coord position = placement.position();
+                    column_t& col = moves.boards[placement.rotation()].board[(size_t)position.x];
+                    const column_t bit = column_t(1) << position.y;
+                    count -= (col & bit) != 0;
+                    col &= ~bit;
+                }
+            };
+
+            // sonic drop of every piece in pieces at once, each one lands on the first blocked cell below it
+            // an occluded fill down through the free cells, then only the cells that rest on something are kept
+            inline Board drop_all(const Board& pieces, const Board& blocked) {
+                Board ret;
+                for (size_t x = 0; x < Board::width; x++) {
+                    column_t fill = pieces.board[x];
+                    column_t free = ~blocked.board[x];
+                    fill |= free & (fill >> 1);
+                    free &= free >> 1;
+                    fill |= free & (fill >> 2);
+                    free &= free >> 2;
+                    fill |= free & (fill >> 4);
+                    free &= free >> 4;
+                    fill |= free & (fill >> 8);
+                    free &= free >> 8;
+                    fill |= free & (fill >> 16);
+                    ret.board[x] = fill & ((blocked.board[x] << 1) | 1);
+                }
+                return ret;
+            }
+
+            // every left and right move of every piece in pieces at once, each one slides as far as the free cells go
+            inline Board slide_all(const Board& pieces, const Board& blocked) {
+                Board ret;
+                column_t right = 0;
+                for (size_t x = 0; x < Board::width; x++) {
+                    right = (right | pieces.board[x]) & ~blocked.board[x];
+                    ret.board[x] = right;
+                }
+                column_t left = 0;
+                for (size_t x = Board::width; x-- > 0;) {
+                    left = (left | pieces.board[x]) & ~blocked.board[x];
+                    ret.board[x] |= left;
+                }
+                return ret;
+            }
+
+            // god_movegen's placements on a low board without its bfs, spins included
+            // it starts from the same hard drops and makes the same moves, but moves every piece on the bitboards at once:
+            // each pass slides both ways as far as the free cells go and sonic drops, until a pass finds nothing new, then it rotates both ways
+            // and with Kicks180 also a half turn
+            template <const KickTable180* Kicks180 = nullptr>
+            inline void flood_placements(const Board& board, PieceType type, PlacementSet& set) {
+                using Smeared::SmearedBoard;
+                const SmearedBoard s_board = Smeared::smear(board, type);
+
+                // I, S and Z start from north and east only and O from north only, like god_movegen
+                const bool symmetric = type == PieceType::I || type == PieceType::S || type == PieceType::Z;
+                const size_t seeded = type == PieceType::O ? 1 : (symmetric ? 2 : 4);
+                SmearedBoard reached{};
+                for (size_t rot = 0; rot < seeded; ++rot)
+                    reached.boards[rot] = Smeared::partial_convex_movegen(s_board.boards[rot], type);
+
+                // every hard drop is already all there is
+                if (s_board.convex(type == PieceType::O)) {
+                    set.moves = reached;
+                    return;
+                }
+
+                // keeps what is new in next and adds it to reached
+                auto discover = [&](SmearedBoard& next) {
+                    s_board.non_collides(next);
+                    for (size_t rot = 0; rot < 4; ++rot) {
+                        for (size_t x = 0; x < Board::width; x++) {
+                            next.boards[rot].board[x] &= ~reached.boards[rot].board[x];
+                            reached.boards[rot].board[x] |= next.boards[rot].board[x];
+                        }
+                    }
+                };
+
+                SmearedBoard::KickMasksSrs kick_masks;
+                SmearedBoard::KickMasks180 kick_masks_180;
+                SmearedBoard frontier = reached;
+                while (!frontier.empty()) {
+                    // slides and drops are cheap, they run until they find nothing before paying for a rotation
+                    SmearedBoard fresh = frontier;
+                    while (!frontier.empty()) {
+                        SmearedBoard next;
+                        for (size_t rot = 0; rot < 4; ++rot) {
+                            next.boards[rot] = slide_all(frontier.boards[rot], s_board.boards[rot]);
+                            next.boards[rot] |= drop_all(next.boards[rot], s_board.boards[rot]);
+                        }
+                        discover(next);
+                        fresh |= next;
+                        frontier = next;
+                    }
+
+                    if (type == PieceType::O)
+                        break;
+                    frontier = s_board.rotate_srs(fresh, type, kick_masks);
+                    if constexpr (Kicks180 != nullptr)
+                        frontier |= s_board.rotate_180(fresh, type, *Kicks180, kick_masks_180);
+                    discover(frontier);
+                }
+
+                // resting on something, and for a spin also stuck to the left, right and above
+                for (size_t rot = 0; rot < 4; ++rot) {
+                    const auto& blocked = s_board.boards[rot].board;
+                    for (size_t x = 0; x < Board::width; x++) {
+                        const column_t moves = reached.boards[rot].board[x] & ((blocked[x] << 1) | 1);
+                        const column_t left = x == 0 ? ~column_t(0) : blocked[x - 1];
+                        const column_t right = x == Board::width - 1 ? ~column_t(0) : blocked[x + 1];
+                        const column_t up = (blocked[x] >> 1) | (column_t(1) << (Board::height - 1));
+                        set.moves.boards[rot].board[x] = moves;
+                        set.spins.boards[rot].board[x] = moves & left & right & up;
+                    }
+                }
+
+                // south and west of I, S and Z fold into north and east the way Smeared::cannonicalize moves them
+                Smeared::fold(set.moves, type);
+                Smeared::fold(set.spins, type);
+            }
+
+            // Kicks180 as for god_movegen
+            template <const KickTable180* Kicks180 = nullptr>
+            inline PlacementSet placement_set(const Board& board, PieceType type) {
+                PlacementSet set;
+                set.type = type;
+                if (type == PieceType::Empty)
+                    return set;
+
+                // the common case never leaves bitboards, god_movegen takes the same shortcut
+                if (board.surface_convex() && board.is_low()) {
+                    set.moves = Smeared::convex_movegen(board, type);
+                }
+                // a low board with holes or overhangs floods the bitboards instead of walking placements one by one,
+                // except O, whose bfs has one rotation and no kicks and beats the flood's setup
+                else if (board.is_low() && type != PieceType::O) {
+                    flood_placements<Kicks180>(board, type, set);
+                }
+                else {
+                    Smeared::god_movegen<Kicks180>(board, type, [&](Placement placement) {
+                        const Coord position = placement.position();
+                        const column_t bit = column_t(1) << position.y;
+                        set.moves.boards[placement.rotation()].board[(size_t)position.x] |= bit;
+                        if (placement.spin() != spinType::null)
+                            set.spins.boards[placement.rotation()].board[(size_t)position.x] |= bit;
+                    });
+                }
+
+                for (const Board& rotation : set.moves.boards)
+                    for (column_t col : rotation.board)
+                        set.count += (u32)std::popcount(col);
+
+                return set;
+            }
+
+            // the current piece and the piece hold would give, same moves as Game::get_possible_placements, 180s included where the mode has them
+            // returns how many of the two sets are in use
+            template <class Mode, size_t Preview>
+            inline size_t placement_sets(const BasicGame<Mode, Preview>& game, std::array<PlacementSet, 2>& sets) {
+                if (game.current_piece.type == PieceType::Empty)
+                    return 0;
+
+                return game.visit_kicks_180([&]<const KickTable180* Kicks180>() -> size_t {
+                    sets[0] = placement_set<Kicks180>(game.board, game.current_piece.type);
+
+                    const PieceType hold_type = game.hold.has_value() ? game.hold.value() : game.queue.front();
+                    if (hold_type == PieceType::Empty || hold_type == game.current_piece.type)
+                        return 1;
+
+                    sets[1] = placement_set<Kicks180>(game.board, hold_type);
+                    return 2;
+                });
+            }
+
+            // one placement, uniform over every placement in sets, which can not all be empty
+            template <random_source Rng>
+            inline Placement sample(std::span<const PlacementSet> sets, Rng& rng) {
+                u32 total = 0;
+                for (const PlacementSet& set : sets)
+                    total += set.count;
+
+                u32 rank = rng.getRand(total);
+                for (const PlacementSet& set : sets) {
+                    if (rank < set.count)
+                        return set.select(rank);
+                    rank -= set.count;
+                }
+                return Placement();
+            }
+
+            // fills out with distinct placements drawn uniformly without replacement
+            // drawn placements are erased from sets, returns how many were written
+            template <random_source Rng>
+            inline size_t sample_distinct(std::span<PlacementSet> sets, Rng& rng, std::span<Placement> out) {
+                size_t written = 0;
+                for (; written < out.size(); ++written) {
+                    u32 total = 0;
+                    for (const PlacementSet& set : sets)
+                        total += set.count;
+                    if (total == 0)
+                        break;
+
+                    u32 rank = rng.getRand(total);
+                    for (PlacementSet& set : sets) {
+                        if (rank < set.count) {
+                            out[written] = set.select(rank);
+                            set.erase(out[written]);
+                            break;
+                        }
+                        rank -= set.count;
+                    }
+                }
+                return written;
+            }
+        };
+    };
+};
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Board.hpp"
+#include "MoveGen.hpp"
+#include "Piece.hpp"
+#include "RotationSystems.hpp"
+#include "ShaktrisConstants.hpp"
+
+namespace Shaktris {
+    namespace MoveGen {
+        namespace PathSearch {
+
+            // inputs from spawn to one known placement, searched from both ends at once
+            // forward from spawn with the moves Game::process_movement has, backward from the placement with the same moves undone,
+            // rotations undone by trying every kick in reverse and keeping the ones srs really takes
+            // both sides grow a whole layer at a time, the smaller one first, and the search stops at the layer they meet in
+            // so the path has the fewest inputs there are
+            class Search {
+               public:
+                static constexpr std::size_t states = RotationDirections_N * Board::width * Board::height;
+
+                // fewest inputs that take the piece from spawn to cover the same cells as target, nothing if it can not get there
+                // a target with a spin has to be reached by rotating into it, which is what makes the spin count
+                std::optional<std::vector<Movement>> find(const Board& board, const Piece& target) {
+                    std::vector<Movement> path;
+                    if (!find(board, target, path))
+                        return std::nullopt;
+                    return path;
+                }
+
+                // same, appending to path, false if there is none
+                bool find(const Board& board, const Piece& target, std::vector<Movement>& path) {
+                    type = target.type;
+                    if (type >= PieceType::Empty)
+                        return false;
+                    s_board = Smeared::smear(board, type);
+                    for (std::size_t rot = 0; rot < RotationDirections_N; ++rot) {
+                        i8 top = 0;
+                        for (const Coord& mino : rot_piece_def[static_cast<std::size_t>(type)][rot])
+                            top = std::max(top, mino.y);
+                        highest[rot] = static_cast<i8>(Board::height - 1 - top);
+                    }
+
+                    forward_distance.fill(-1);
+                    backward_distance.fill(-1);
+                    forward_count = backward_count = 0;
+
+                    const SmearedPiece spawn{ Coord((i8)(Board::width / 2 - 1), piece_spawn_height), 0 };
+                    if (!fits(spawn))
+                        return false;
+
+                    const bool needs_spin = target.spin != spinType::null && type != PieceType::O;
+                    for (std::size_t rot = 0; rot < RotationDirections_N; ++rot) {
+                        const std::optional<SmearedPiece> goal = same_cells(target, static_cast<u8>(rot));
+                        if (!goal || !fits(*goal))
+                            continue;
+                        if (!needs_spin) {
+                            discover_backward(*goal, index(*goal), Movement::SonicDrop, 0);
+                            continue;
+                        }
+                        // only the rotations into it count, the goal itself is left unmarked
+                        rotations_into(*goal, [&](const SmearedPiece& from, Movement movement) {
+                            discover_backward(from, index(*goal), movement, 1);
+                        });
+                    }
+
+                    discover_forward(spawn, index(spawn), Movement::SonicDrop, 0);
+                    std::size_t forward_begin = 0;
+                    std::size_t backward_begin = 0;
+                    best = -1;
+                    meet = 0;
+                    if (backward_distance[index(spawn)] >= 0)
+                        record(index(spawn));
+
+                    while (best < 0 && forward_begin < forward_count && backward_begin < backward_count) {
+                        if (forward_count - forward_begin <= backward_count - backward_begin) {
+                            const std::size_t end = forward_count;
+                            for (; forward_begin < end; ++forward_begin)
+                                expand_forward(forward_queue[forward_begin]);
+                        }
+                        else {
+                            const std::size_t end = backward_count;
+                            for (; backward_begin < end; ++backward_begin)
+                                expand_backward(backward_queue[backward_begin]);
+                        }
+                    }
+                    if (best < 0)
+                        return false;
+
+                    // spawn to the meeting state, then the meeting state to the goal
+                    const std::size_t start = path.size();
+                    for (u16 state = meet; forward_distance[state] > 0; state = forward_parent[state])
+                        path.push_back(forward_move[state]);
+                    std::reverse(path.begin() + static_cast<std::ptrdiff_t>(start), path.end());
+                    // counted rather than walked to a zero, the goal of a spin is never marked itself
+                    u16 state = meet;
+                    for (i16 left = backward_distance[meet]; left > 0; --left, state = backward_next[state])
+                        path.push_back(backward_move[state]);
+                    return true;
+                }
+
+               private:
+                using SmearedPiece = Smeared::SmearedPiece;
+
+                static u16 index(const SmearedPiece& piece) {
+                    return static_cast<u16>(piece.rot * Board::width * Board::height + piece.position.x * Board::height + piece.position.y);
+                }
+
+                static SmearedPiece state(u16 i) {
+                    return { Coord((i8)((i / Board::height) % Board::width), (i8)(i % Board::height)), (u8)(i / (Board::width * Board::height)) };
+                }
+
+                bool fits(const SmearedPiece& piece) const {
+                    if (piece.position.x < 0 || piece.position.x >= (i8)Board::width || piece.position.y < 0 || piece.position.y > highest[piece.rot])
+                        return false;
+                    return !(s_board.boards[piece.rot].board[static_cast<std::size_t>(piece.position.x)] & (column_t(1) << piece.position.y));
+                }
+
+                // the state of rotation rot covering the cells target covers, if there is one
+                std::optional<SmearedPiece> same_cells(const Piece& target, u8 rot) const {
+                    const auto& minos = rot_piece_def[static_cast<std::size_t>(type)][rot];
+                    const Coord first{ (i8)(target.minos[0].x + target.position.x), (i8)(target.minos[0].y + target.position.y) };
+                    for (const Coord& anchor : minos) {
+                        const Coord center{ (i8)(first.x - anchor.x), (i8)(first.y - anchor.y) };
+                        bool same = true;
+                        for (const Coord& mino : minos) {
+                            bool found = false;
+                            for (const Coord& cell : target.minos)
+                                found |= cell.x + target.position.x == mino.x + center.x && cell.y + target.position.y == mino.y + center.y;
+                            same &= found;
+                        }
+                        if (same)
+                            return SmearedPiece{ center, rot };
+                    }
+                    return std::nullopt;
+                }
+
+                static Coord kick(PieceType type, u8 from, u8 to, std::size_t i) {
+                    const auto& offsets = type == PieceType::I ? piece_offsets_I : (type == PieceType::O ? piece_offsets_O : piece_offsets_JLSTZ);
+                    return Coord((i8)(offsets[from][i].x - offsets[to][i].x), (i8)(offsets[from][i].y - offsets[to][i].y));
+                }
+
+                // srs_rotate on the smeared board, the first kick that fits
+                std::optional<SmearedPiece> rotate(const SmearedPiece& piece, Movement movement) const {
+                    const u8 to = static_cast<u8>((piece.rot + (movement == Movement::RotateClockwise ? 1 : 3)) % 4);
+                    for (std::size_t i = 0; i < srs_kicks; ++i) {
+                        const Coord offset = kick(type, piece.rot, to, i);
+                        const SmearedPiece next{ Coord((i8)(piece.position.x + offset.x), (i8)(piece.position.y + offset.y)), to };
+                        if (fits(next))
+                            return next;
+                    }
+                    return std::nullopt;
+                }
+
+                // every state that one rotation takes to piece
+                template <class F>
+                void rotations_into(const SmearedPiece& piece, F&& f) const {
+                    if (type == PieceType::O)
+                        return;
+                    for (const Movement movement : { Movement::RotateClockwise, Movement::RotateCounterClockwise }) {
+                        const u8 from = static_cast<u8>((piece.rot + (movement == Movement::RotateClockwise ? 3 : 1)) % 4);
+                        for (std::size_t i = 0; i < srs_kicks; ++i) {
+                            const Coord offset = kick(type, from, piece.rot, i);
+                            const SmearedPiece previous{ Coord((i8)(piece.position.x - offset.x), (i8)(piece.position.y - offset.y)), from };
+                            // an earlier kick that fits would have been taken instead
+                            if (!fits(previous))
+                                continue;
+                            const std::optional<SmearedPiece> rotated = rotate(previous, movement);
+                            if (rotated && index(*rotated) == index(piece))
+                                f(previous, movement);
+                        }
+                    }
+                }
+
+                void record(u16 i) {
+                    const int length = forward_distance[i] + backward_distance[i];
+                    if (best < 0 || length < best) {
+                        best = length;
+                        meet = i;
+                    }
+                }
+
+                void discover_forward(const SmearedPiece& piece, u16 parent, Movement movement, i16 distance) {
+                    const u16 i = index(piece);
+                    if (forward_distance[i] >= 0)
+                        return;
+                    forward_distance[i] = distance;
+                    forward_parent[i] = parent;
+                    forward_move[i] = movement;
+                    forward_queue[forward_count++] = i;
+                    if (backward_distance[i] >= 0)
+                        record(i);
+                }
+
+                void discover_backward(const SmearedPiece& piece, u16 next, Movement movement, i16 distance) {
+                    const u16 i = index(piece);
+                    if (backward_distance[i] >= 0)
+                        return;
+                    backward_distance[i] = distance;
+                    backward_next[i] = next;
+                    backward_move[i] = movement;
+                    backward_queue[backward_count++] = i;
+                    if (forward_distance[i] >= 0)
+                        record(i);
+                }
+
+                void expand_forward(u16 i) {
+                    const SmearedPiece piece = state(i);
+                    const i16 distance = forward_distance[i] + 1;
+
+                    for (const auto& [dx, movement] : { std::pair{ -1, Movement::Left }, std::pair{ 1, Movement::Right } }) {
+                        const SmearedPiece next{ Coord((i8)(piece.position.x + dx), piece.position.y), piece.rot };
+                        if (fits(next))
+                            discover_forward(next, i, movement, distance);
+                    }
+
+                    if (type != PieceType::O) {
+                        for (const Movement movement : { Movement::RotateClockwise, Movement::RotateCounterClockwise }) {
+                            if (const std::optional<SmearedPiece> next = rotate(piece, movement))
+                                discover_forward(*next, i, movement, distance);
+                        }
+                    }
+
+                    const column_t below = s_board.boards[piece.rot].board[static_cast<std::size_t>(piece.position.x)] & ((column_t(1) << piece.position.y) - 1);
+                    const i8 landing = static_cast<i8>(std::bit_width(below));
+                    if (landing != piece.position.y)
+                        discover_forward({ Coord(piece.position.x, landing), piece.rot }, i, Movement::SonicDrop, distance);
+                }
+
+                void expand_backward(u16 i) {
+                    const SmearedPiece piece = state(i);
+                    const i16 distance = backward_distance[i] + 1;
+
+                    // shifting back the other way
+                    for (const auto& [dx, movement] : { std::pair{ 1, Movement::Left }, std::pair{ -1, Movement::Right } }) {
+                        const SmearedPiece previous{ Coord((i8)(piece.position.x + dx), piece.position.y), piece.rot };
+                        if (fits(previous))
+                            discover_backward(previous, i, movement, distance);
+                    }
+
+                    rotations_into(piece, [&](const SmearedPiece& previous, Movement movement) {
+                        discover_backward(previous, i, movement, distance);
+                    });
+
+                    // a drop lands here from anywhere straight above with nothing in between
+                    const column_t col = s_board.boards[piece.rot].board[static_cast<std::size_t>(piece.position.x)];
+                    const bool grounded = piece.position.y == 0 || (col & (column_t(1) << (piece.position.y - 1)));
+                    if (!grounded)
+                        return;
+                    for (SmearedPiece previous{ Coord(piece.position.x, (i8)(piece.position.y + 1)), piece.rot }; fits(previous); previous.position.y++)
+                        discover_backward(previous, i, Movement::SonicDrop, distance);
+                }
+
+                PieceType type = PieceType::Empty;
+                Smeared::SmearedBoard s_board{};
+                // highest center y of each rotation that keeps every mino on the board
+                std::array<i8, RotationDirections_N> highest{};
+
+                std::array<i16, states> forward_distance;
+                std::array<i16, states> backward_distance;
+                std::array<u16, states> forward_parent;
+                std::array<u16, states> backward_next;
+                std::array<Movement, states> forward_move;
+                std::array<Movement, states> backward_move;
+                std::array<u16, states> forward_queue;
+                std::array<u16, states> backward_queue;
+                std::size_t forward_count = 0;
+                std::size_t backward_count = 0;
+
+                int best = -1;
+                u16 meet = 0;
+            };
+
+            // one off search, keep a Search around to reuse its buffers
+            inline std::optional<std::vector<Movement>> find_path(const Board& board, const Piece& target) {
+                Search search;
+                return search.find(board, target);
+            }
+        };
+    };
+};
@@ -43,6 +43,8 @@ public:
     ~Piece() noexcept = default;
     Piece& operator=(const Piece& other) noexcept = default;
 
+    constexpr bool operator==(const Piece& other) const noexcept = default;
+
 
     constexpr inline void rotate(TurnDirection direction) {
         if (direction == TurnDirection::Left) {
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+
+#include "ShaktrisConstants.hpp"
+
+// the preview, N pieces packed three bits each into one u64 with the next piece in the low bits
+// advancing is a shift no matter how long the preview is, and the raw bits go straight into hashes and GameState
+// slots past the end of what was dealt hold PieceType::Empty
+template <std::size_t N>
+class PieceQueue {
+public:
+    static constexpr int piece_bits = 3;
+    static constexpr u64 piece_mask = (1 << piece_bits) - 1;
+
+    static_assert(N > 0 && N * piece_bits <= 64, "preview does not fit in a u64");
+    static_assert(static_cast<u64>(PieceType::Empty) == piece_mask, "empty slots are found by looking for all bits set");
+
+    // the lowest bit of every slot, and every slot set to Empty
+    static constexpr u64 slot_low_bits = [] {
+        u64 ret = 0;
+        for (std::size_t i = 0; i < N; ++i)
+            ret |= u64(1) << (piece_bits * i);
+        return ret;
+    }();
+    static constexpr u64 empty_bits = slot_low_bits * piece_mask;
+
+    constexpr PieceQueue() noexcept = default;
+
+    constexpr PieceQueue(std::initializer_list<PieceType> pieces) noexcept
+        : PieceQueue(std::span<const PieceType>(pieces.begin(), pieces.size())) {}
+
+    // takes the first N pieces, anything shorter leaves the rest empty
+    constexpr explicit PieceQueue(std::span<const PieceType> pieces) noexcept {
+        for (std::size_t i = 0; i < N && i < pieces.size(); ++i)
+            set(i, pieces[i]);
+    }
+
+    static constexpr PieceQueue from_raw(u64 raw) noexcept {
+        PieceQueue ret;
+        ret.bits = raw & empty_bits;
+        return ret;
+    }
+
+    constexpr u64 raw() const noexcept {
+        return bits;
+    }
+
+    static constexpr std::size_t size() noexcept {
+        return N;
+    }
+
+    constexpr PieceType operator[](std::size_t i) const noexcept {
+        return static_cast<PieceType>((bits >> (piece_bits * i)) & piece_mask);
+    }
+
+    constexpr void set(std::size_t i, PieceType type) noexcept {
+        const int shift = piece_bits * static_cast<int>(i);
+        bits = (bits & ~(piece_mask << shift)) | (static_cast<u64>(type) << shift);
+    }
+
+    constexpr PieceType front() const noexcept {
+        return (*this)[0];
+    }
+
+    constexpr PieceType back() const noexcept {
+        return (*this)[N - 1];
+    }
+
+    // removes the next piece and returns it, the back slot becomes empty
+    constexpr PieceType pop_front() noexcept {
+        const PieceType ret = front();
+        bits = (bits >> piece_bits) | (piece_mask << (piece_bits * (N - 1)));
+        return ret;
+    }
+
+    // how many pieces are dealt, the first empty slot
+    constexpr std::size_t count() const noexcept {
+        const u64 empty = bits & (bits >> 1) & (bits >> 2) & slot_low_bits;
+        return empty ? static_cast<std::size_t>(std::countr_zero(empty)) / piece_bits : N;
+    }
+
+    // deals a piece into the first empty slot, a full queue drops it
+    constexpr void push(PieceType type) noexcept {
+        const std::size_t i = count();
+        if (i < N)
+            set(i, type);
+    }
+
+    constexpr bool operator==(const PieceQueue& other) const noexcept = default;
+
+private:
+    u64 bits = empty_bits;
+};
+
+// sanity test
+consteval bool piece_queue_test() {
+    PieceQueue<6> queue{ PieceType::I, PieceType::O, PieceType::L };
+    if (queue.count() != 3 || queue[3] != PieceType::Empty)
+        return false;
+    queue.push(PieceType::T);
+    if (queue.pop_front() != PieceType::I || queue.front() != PieceType::O || queue.count() != 3 || queue[2] != PieceType::T)
+        return false;
+    for (int i = 0; i < 6; ++i)
+        queue.push(PieceType::S);
+    if (queue.count() != 6 || queue.back() != PieceType::S)
+        return false;
+
+    PieceQueue<21> full;
+    full.set(20, PieceType::Z);
+    return full.count() == 0 && full.back() == PieceType::Z && full.pop_front() == PieceType::Empty && full[19] == PieceType::Z;
+}
+
+static_assert(piece_queue_test(), "piece queue didnt work");
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <compare>
+
+#include "Piece.hpp"
+#include "BitPiece.hpp"
+#include "Board.hpp"
+#include "ShaktrisConstants.hpp"
+
+// a placement packed into 16 bits
+// a Piece carries its own copy of the minos and ends up around 14 bytes, this is only what movegen actually decides
+// the minos come back out of rot_piece_def when expanding it
+class Placement {
+public:
+    static constexpr int type_bits = 3;
+    static constexpr int rotation_bits = 2;
+    static constexpr int x_bits = 4;
+    static constexpr int y_bits = 5;
+    static constexpr int spin_bits = 2;
+
+    static constexpr int type_shift = 0;
+    static constexpr int rotation_shift = type_shift + type_bits;
+    static constexpr int x_shift = rotation_shift + rotation_bits;
+    static constexpr int y_shift = x_shift + x_bits;
+    static constexpr int spin_shift = y_shift + y_bits;
+
+    static_assert(spin_shift + spin_bits <= 16, "placement does not fit in 16 bits");
+    static_assert(Board::width <= (1 << x_bits) && Board::height <= (1 << y_bits), "board does not fit in a placement");
+
+    constexpr Placement() noexcept = default;
+
+    constexpr Placement(PieceType type, RotationDirection rotation, Coord position, spinType spin = spinType::null) noexcept
+        : bits(static_cast<u16>(
+            (static_cast<u16>(type) << type_shift) |
+            (static_cast<u16>(rotation) << rotation_shift) |
+            (static_cast<u16>(position.x) << x_shift) |
+            (static_cast<u16>(position.y) << y_shift) |
+            (static_cast<u16>(spin) << spin_shift))) {}
+
+    constexpr explicit Placement(const Piece& piece) noexcept
+        : Placement(piece.type, piece.rotation, piece.position, piece.spin) {}
+
+    static constexpr Placement from_raw(u16 raw) noexcept {
+        Placement ret;
+        ret.bits = raw;
+        return ret;
+    }
+
+    constexpr u16 raw() const noexcept {
+        return bits;
+    }
+
+    constexpr PieceType type() const noexcept {
+        return static_cast<PieceType>(field(type_shift, type_bits));
+    }
+
+    constexpr RotationDirection rotation() const noexcept {
+        return static_cast<RotationDirection>(field(rotation_shift, rotation_bits));
+    }
+
+    constexpr Coord position() const noexcept {
+        return Coord{ static_cast<i8>(field(x_shift, x_bits)), static_cast<i8>(field(y_shift, y_bits)) };
+    }
+
+    constexpr spinType spin() const noexcept {
+        return static_cast<spinType>(field(spin_shift, spin_bits));
+    }
+
+    constexpr Piece to_piece() const noexcept {
+        return Piece(type(), rotation(), position(), spin());
+    }
+
+    // BitPiece keeps the bottom left corner of its 4x4 box instead of the rotation center
+    constexpr BitPiece to_bit_piece() const noexcept {
+        BitPiece ret(type(), rotation());
+        const Coord center = position();
+        ret.pos = Coord{ static_cast<i8>(center.x - 1), static_cast<i8>(center.y - 1) };
+        for (size_t i = 0; i < ret.bit_piece.size(); ++i) {
+            const column_t column = bit_piece_rot_def[static_cast<size_t>(type())][static_cast<size_t>(rotation())][i];
+            ret.bit_piece[i] = ret.pos.y >= 0 ? column << ret.pos.y : column >> -ret.pos.y;
+        }
+        ret.spin = spin();
+        return ret;
+    }
+
+    constexpr auto operator<=>(const Placement& other) const noexcept = default;
+
+private:
+    constexpr u16 field(int shift, int width) const noexcept {
+        return static_cast<u16>((bits >> shift) & ((1 << width) - 1));
+    }
+
+    u16 bits = 0;
+};
+
+static_assert(sizeof(Placement) == 2, "Placement should be 16 bits");
+
+// sanity test
+consteval bool placement_round_trip_test() {
+    for (size_t type = 0; type < static_cast<size_t>(PieceType::Empty); ++type) {
+        for (size_t rot = 0; rot < RotationDirections_N; ++rot) {
+            const Piece piece(static_cast<PieceType>(type), static_cast<RotationDirection>(rot), Coord{ 9, 31 }, spinType::normal);
+            const Piece back = Placement(piece).to_piece();
+            if (back.type != piece.type || back.rotation != piece.rotation || back.position.x != piece.position.x ||
+                back.position.y != piece.position.y || back.spin != piece.spin || back.minos[0].x != piece.minos[0].x)
+                return false;
+        }
+    }
+    return true;
+}
+
+static_assert(placement_round_trip_test(), "placement round trip didnt work");
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <climits>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <span>
+
+#include "Board.hpp"
+#include "Game.hpp"
+#include "MoveGen.hpp"
+#include "Piece.hpp"
+#include "Placement.hpp"
+#include "ShaktrisConstants.hpp"
+
+namespace Shaktris {
+    namespace MoveGen {
+        namespace Reachability {
+
+            // whether one placement is among the ones Smeared::god_movegen gives, without generating the rest
+            // most placements are answered from the smeared board alone: anything that does not fit or is not grounded is out,
+            // and on a low board anything a piece falls straight into from above is in
+            // the rest run god_movegen's search, stopping as soon as the placement comes up
+            //
+            // the south and west states of I, S and Z count as the north and east state covering the same cells, every state of O as north
+            // a placement overlapping the board is refused, god_movegen gives the spawn even then since it never checks it
+            // the spin is not checked here, reachable_spin gives the one god_movegen would give
+            // Kicks180 as for god_movegen, a game passes its mode's through BasicGame::visit_kicks_180
+            template <const KickTable180* Kicks180 = nullptr>
+            inline std::optional<spinType> reachable_spin(const Board& board, Placement placement) {
+                using namespace Smeared;
+
+                const PieceType type = placement.type();
+                const Coord position = placement.position();
+                if (type >= PieceType::Empty || position.x >= (i8)Board::width)
+                    return std::nullopt;
+
+                const SmearedBoard s_board = smear(board, type);
+                const SmearedPiece target{ position, static_cast<u8>(placement.rotation()) };
+                const column_t target_col = s_board.boards[target.rot].board[static_cast<size_t>(target.position.x)];
+                const bool fits = !(target_col & (column_t(1) << target.position.y));
+                const bool grounded = target.position.y == 0 || (target_col & (column_t(1) << (target.position.y - 1)));
+                if (!fits || !grounded)
+                    return std::nullopt;
+
+                const SmearedPiece goal = cannonicalize(target, type);
+                if (goal.position.x < 0 || goal.position.x >= (i8)Board::width)
+                    return std::nullopt;
+
+                // where a piece dropped from the sky lands, same as partial_convex_movegen for one column
+                auto dropped = [&](const SmearedPiece& piece) {
+                    const column_t col = s_board.boards[piece.rot].board[static_cast<size_t>(piece.position.x)];
+                    if (col >= std::numeric_limits<column_t>::max() >> 2)
+                        return false;
+                    return (sizeof(column_t) * CHAR_BIT) - std::countl_zero(col) == (size_t)piece.position.y;
+                };
+
+                // god_movegen's shortcuts, the placements are only the ones straight down and never spins
+                if ((board.surface_convex() && board.is_low()) || s_board.convex(PieceType::O == type))
+                    return dropped(goal) ? std::optional(spinType::null) : std::nullopt;
+
+                const auto spin = [&] {
+                    return is_immobile(s_board, target) ? spinType::normal : spinType::null;
+                };
+
+                std::array<SmearedFrontier, 2> frontiers;
+                SmearedFrontier* open_nodes = &frontiers[0];
+                SmearedFrontier* next_nodes = &frontiers[1];
+                std::bitset<32 * 10 * 4> visited;
+                bool found = false;
+                auto push = [&](SmearedFrontier& nodes, const SmearedPiece& piece) {
+                    const size_t iter = piece.position.y + piece.position.x * 32 + piece.rot * 32 * 10;
+                    if (visited[iter])
+                        return;
+                    visited[iter] = true;
+                    nodes.push_back(piece);
+
+                    const column_t col = s_board.boards[piece.rot].board[static_cast<size_t>(piece.position.x)];
+                    if (piece.position.y == 0 || (col & (column_t(1) << (piece.position.y - 1)))) {
+                        const SmearedPiece canonical = cannonicalize(piece, type);
+                        found |= canonical.rot == goal.rot && canonical.position.x == goal.position.x && canonical.position.y == goal.position.y;
+                    }
+                };
+
+                if (board.is_low()) {
+                    // every column is open from above, which is also the cheap answer for most placements
+                    if (dropped(goal))
+                        return spin();
+
+                    const size_t rotations = type == PieceType::O ? 1 : (type == PieceType::I || type == PieceType::Z || type == PieceType::S) ? 2 : 4;
+                    for (size_t rot = 0; rot < rotations; ++rot) {
+                        const Board seeds = partial_convex_movegen(s_board.boards[rot], type);
+                        for (size_t x = 0; x < Board::width; ++x) {
+                            if (seeds.board[x])
+                                push(*open_nodes, SmearedPiece{ Coord((i8)x, (i8)std::countr_zero(seeds.board[x])), (u8)rot });
+                        }
+                    }
+                }
+                else {
+                    push(*open_nodes, { Coord((i8)4, piece_spawn_height), 0 });
+                }
+
+                while (!found && !open_nodes->empty()) {
+                    for (const SmearedPiece& piece : *open_nodes) {
+                        const auto& rotation = s_board.boards[static_cast<size_t>(piece.rot)];
+
+                        if (piece.position.x > 0 && !(rotation.board[static_cast<size_t>(piece.position.x - 1)] & (1 << piece.position.y)))
+                            push(*next_nodes, { Coord(piece.position.x - 1, piece.position.y), piece.rot });
+
+                        if (piece.position.x < (i8)(Board::width - 1) && !(rotation.board[static_cast<size_t>(piece.position.x + 1)] & (1 << piece.position.y)))
+                            push(*next_nodes, { Coord(piece.position.x + 1, piece.position.y), piece.rot });
+
+                        {
+                            const column_t below = rotation.board[static_cast<size_t>(piece.position.x)] & ((1 << piece.position.y) - 1);
+                            const auto height = ((int)sizeof(column_t) * 8) - std::countl_zero(below);
+                            push(*next_nodes, { Coord(piece.position.x, height), piece.rot });
+                        }
+
+                        if (type != PieceType::O) {
+                            SmearedPiece next_piece = piece;
+                            srs<TurnDirection::Right>(s_board, next_piece, type);
+                            push(*next_nodes, next_piece);
+
+                            next_piece = piece;
+                            srs<TurnDirection::Left>(s_board, next_piece, type);
+                            push(*next_nodes, next_piece);
+
+                            if constexpr (Kicks180 != nullptr) {
+                                next_piece = piece;
+                                srs_180(s_board, next_piece, type, *Kicks180);
+                                push(*next_nodes, next_piece);
+                            }
+                        }
+
+                        if (found)
+                            break;
+                    }
+                    std::swap(open_nodes, next_nodes);
+                    next_nodes->clear();
+                }
+
+                if (!found)
+                    return std::nullopt;
+                return spin();
+            }
+
+            template <const KickTable180* Kicks180 = nullptr>
+            inline bool is_reachable(const Board& board, Placement placement) {
+                return reachable_spin<Kicks180>(board, placement).has_value();
+            }
+
+            template <const KickTable180* Kicks180 = nullptr>
+            inline bool is_reachable(const Board& board, const Piece& piece) {
+                return is_reachable<Kicks180>(board, Placement(piece));
+            }
+
+            // reachable and with the spin god_movegen gives it, so a remote player can not claim a spin they did not do
+            template <const KickTable180* Kicks180 = nullptr>
+            inline bool is_legal(const Board& board, Placement placement) {
+                const std::optional<spinType> spin = reachable_spin<Kicks180>(board, placement);
+                return spin.has_value() && *spin == placement.spin();
+            }
+
+            // what Game::place_piece needs checked before it trusts a piece from outside:
+            // the piece is the current one or the one hold gives, and it is legal on the board
+            template <class Mode, std::size_t Preview>
+            inline bool is_legal_move(const BasicGame<Mode, Preview>& game, const Piece& piece) {
+                if (game.current_piece.type == PieceType::Empty || piece.type == PieceType::Empty)
+                    return false;
+                const PieceType hold_type = game.hold.has_value() ? game.hold.value() : game.queue.front();
+                if (piece.type != game.current_piece.type && piece.type != hold_type)
+                    return false;
+                return game.visit_kicks_180([&]<const KickTable180* Kicks180>() { return is_legal<Kicks180>(game.board, Placement(piece)); });
+            }
+
+            // one placement per board, out[i] is 1 if placements[i] is legal on boards[i], spin included, without 180s
+            inline void is_legal(std::span<const Board> boards, std::span<const Placement> placements, std::span<u8> out) {
+                for (std::size_t i = 0; i < boards.size(); ++i)
+                    out[i] = is_legal(boards[i], placements[i]);
+            }
+        };
+    };
+};
@@ -30,8 +30,105 @@ constexpr std::array<std::array<Coord, srs_kicks>, RotationDirections_N> piece_o
     {{{0, 1}, {0, 1}, {0, 1}, {0, -1}, {0, 2}}},
 } };
 
+// 180 kicks are tried as they are, after the shift srs's first offset gives the piece, which is nothing except for I and O
+// one table per starting rotation, indexed like the offsets above
+constexpr std::size_t max_kicks_180 = 6;
+
+struct KickTable180 {
+    std::size_t kicks;
+    std::array<std::array<Coord, max_kicks_180>, RotationDirections_N> jlstz;
+    std::array<std::array<Coord, max_kicks_180>, RotationDirections_N> i;
+
+    constexpr const std::array<Coord, max_kicks_180>& table(PieceType type, std::size_t from) const {
+        return type == PieceType::I ? i[from] : jlstz[from];
+    }
+};
+
+// tetr.io's srs+, the same for every piece
+inline constexpr KickTable180 tetrio_180_kicks = {
+    6,
+    { {
+        {{{0, 0}, {0, 1}, {1, 1}, {-1, 1}, {1, 0}, {-1, 0}}},
+        {{{0, 0}, {1, 0}, {1, 2}, {1, 1}, {0, 2}, {0, 1}}},
+        {{{0, 0}, {0, -1}, {-1, -1}, {1, -1}, {-1, 0}, {1, 0}}},
+        {{{0, 0}, {-1, 0}, {-1, 2}, {-1, 1}, {0, 2}, {0, 1}}},
+    } },
+    { {
+        {{{0, 0}, {0, 1}, {1, 1}, {-1, 1}, {1, 0}, {-1, 0}}},
+        {{{0, 0}, {1, 0}, {1, 2}, {1, 1}, {0, 2}, {0, 1}}},
+        {{{0, 0}, {0, -1}, {-1, -1}, {1, -1}, {-1, 0}, {1, 0}}},
+        {{{0, 0}, {-1, 0}, {-1, 2}, {-1, 1}, {0, 2}, {0, 1}}},
+    } },
+};
+
+// turns in place or not at all
+inline constexpr KickTable180 no_180_kicks = { 1, {}, {} };
+
+// for rulesets without 180s, the turn never happens
+inline constexpr KickTable180 no_180_turns = { 0, {}, {} };
+
+// where the i-th 180 kick puts a piece of type turning from rotation from, relative to where it was
+constexpr Coord kick_180(const KickTable180& kicks, PieceType type, std::size_t from, std::size_t i) {
+    const std::size_t to = (from + 2) % RotationDirections_N;
+    const auto& offsets = type == PieceType::I ? piece_offsets_I : (type == PieceType::O ? piece_offsets_O : piece_offsets_JLSTZ);
+    const Coord kick = kicks.table(type, from)[i];
+    return Coord((i8)(offsets[from][0].x - offsets[to][0].x + kick.x), (i8)(offsets[from][0].y - offsets[to][0].y + kick.y));
+}
+
+// compile time unit tests for sanity
+consteval bool kick_180_test() {
+    for (std::size_t type = 0; type < (std::size_t)PieceType::Empty; ++type) {
+        for (std::size_t from = 0; from < RotationDirections_N; ++from) {
+            // turning twice in place comes back to the same spot
+            const Coord there = kick_180(tetrio_180_kicks, (PieceType)type, from, 0);
+            const Coord back = kick_180(tetrio_180_kicks, (PieceType)type, (from + 2) % RotationDirections_N, 0);
+            if (there.x + back.x != 0 || there.y + back.y != 0)
+                return false;
+        }
+    }
+    // and O covers the same cells after turning
+    const Coord o = kick_180(tetrio_180_kicks, PieceType::O, 0, 0);
+    for (const Coord& mino : rot_piece_def[(std::size_t)PieceType::O][2]) {
+        bool found = false;
+        for (const Coord& north : rot_piece_def[(std::size_t)PieceType::O][0])
+            found |= north.x == mino.x + o.x && north.y == mino.y + o.y;
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+static_assert(kick_180_test(), "180 kicks didnt work");
+
 using rotation_function = void (*)(const Board&, Piece&, TurnDirection);
 
+// the three corner rule, a mini with both back corners filled unless it took the last kick
+inline spinType t_corner_spin(const Board& board, const Piece& piece, bool last_kick) {
+    constexpr std::array<std::array<Coord, 4>, 4> corners = { {
+            // a       b       c        d
+            {{{-1,  1}, { 1,  1}, { 1, -1}, {-1, -1}}},  // North
+            {{{ 1,  1}, { 1, -1}, {-1, -1}, {-1,  1}}},  // East
+            {{{ 1, -1}, {-1, -1}, {-1,  1}, { 1,  1}}},  // South
+            {{{-1, -1}, {-1,  1}, { 1,  1}, { 1, -1}}},  // West
+        } };
+
+    bool filled[4] = { true, true, true, true };
+
+    for (size_t u = 0; u < 4; u++) {
+        Coord c = corners[piece.rotation][u];
+        c.x += piece.position.x;
+        c.y += piece.position.y;
+        if (c.x >= 0 && c.x < (i8)Board::width)
+            filled[u] = board.get(c.x, c.y);
+    }
+
+    if (filled[0] && filled[1] && (filled[2] || filled[3]))
+        return spinType::normal;
+    if ((filled[0] || filled[1]) && filled[2] && filled[3])
+        return last_kick ? spinType::normal : spinType::mini;
+    return spinType::null;
+}
+
 inline void srs_rotate(const Board& board,Piece& piece, TurnDirection dir) {
     const RotationDirection prev_rot = piece.rotation;
 
@@ -56,37 +153,8 @@ inline void srs_rotate(const Board& board,Piece& piece, TurnDirection dir) {
         piece.position.x = x + (*prev_offsets)[i].x - (*offsets)[i].x;
         piece.position.y = y + (*prev_offsets)[i].y - (*offsets)[i].y;
         if (!Shaktris::Utility::collides(board, piece)) {
-            if (piece.type == PieceType::T) {
-                constexpr std::array<std::array<Coord, 4>, 4> corners = { {
-                        // a       b       c        d
-                        {{{-1,  1}, { 1,  1}, { 1, -1}, {-1, -1}}},  // North
-                        {{{ 1,  1}, { 1, -1}, {-1, -1}, {-1,  1}}},  // East
-                        {{{ 1, -1}, {-1, -1}, {-1,  1}, { 1,  1}}},  // South
-                        {{{-1, -1}, {-1,  1}, { 1,  1}, { 1, -1}}},  // West
-                    } };
-
-                bool filled[4] = { true, true, true, true };
-
-                for (size_t u = 0; u < 4; u++) {
-                    Coord c = corners[piece.rotation][u];
-                    c.x += piece.position.x;
-                    c.y += piece.position.y;
-                    if (c.x >= 0 && c.x < Board::width)
-                        filled[u] = board.get(c.x, c.y);
-                }
-
-                if (filled[0] && filled[1] && (filled[2] || filled[3]))
-                    piece.spin = spinType::normal;
-                else if ((filled[0] || filled[1]) && filled[2] && filled[3]) {
-                    if (i >= (srs_kicks - 1)) {
-                        piece.spin = spinType::normal;
-                    }
-                    else
-                        piece.spin = spinType::mini;
-                }
-                else
-                    piece.spin = spinType::null;
-            }
+            if (piece.type == PieceType::T)
+                piece.spin = t_corner_spin(board, piece, i >= (srs_kicks - 1));
             return;
         }
     }
@@ -99,6 +167,31 @@ inline void srs_rotate(const Board& board,Piece& piece, TurnDirection dir) {
 
 
 
+// turns the piece around with the first 180 kick that fits, T spins by the corner rule with no kick counting as the last
+inline void srs_rotate_180(const Board& board, Piece& piece, const KickTable180& kicks = tetrio_180_kicks) {
+    const std::size_t from = static_cast<std::size_t>(piece.rotation);
+    const Coord position = piece.position;
+
+    piece.rotate(TurnDirection::Right);
+    piece.rotate(TurnDirection::Right);
+
+    for (std::size_t i = 0; i < kicks.kicks; i++) {
+        const Coord kick = kick_180(kicks, piece.type, from, i);
+        piece.position.x = position.x + kick.x;
+        piece.position.y = position.y + kick.y;
+        if (!Shaktris::Utility::collides(board, piece)) {
+            if (piece.type == PieceType::T)
+                piece.spin = t_corner_spin(board, piece, false);
+            return;
+        }
+    }
+
+    piece.position = position;
+    piece.rotate(TurnDirection::Left);
+    piece.rotate(TurnDirection::Left);
+}
+
+
 inline void srs_all_spin_rotate(const Board& board, Piece& piece, TurnDirection dir) {
     const RotationDirection prev_rot = piece.rotation;
 
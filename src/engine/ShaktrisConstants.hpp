@@ -6,7 +6,9 @@
 using u8 =  uint8_t ;    ///<   8-bit unsigned integer.
 using i8 =   int8_t ;     ///<   8-bit signed integer.
 using u16 = uint16_t ;  ///<  16-bit unsigned integer.
+using i16 =  int16_t ;   ///<  16-bit signed integer.
 using u32 = uint32_t ;  ///<  32-bit unsigned integer.
+using i32 =  int32_t ;   ///<  32-bit signed integer.
 using u64 = uint64_t ;  ///<  64-bit unsigned integer.
 
 
@@ -20,6 +22,8 @@ enum class spinType : u8 {
 struct Coord {
     i8 x;
     i8 y;
+
+    constexpr bool operator==(const Coord& other) const = default;
 };
 
 enum RotationDirection : u8 {
@@ -71,6 +75,8 @@ enum class Movement : u8 {
     RotateClockwise,
     RotateCounterClockwise,
     SonicDrop,
+    // only where the ruleset allows it, kicks come from a KickTable180
+    Rotate180,
 };
 
 // number of kicks srs has, including for initial
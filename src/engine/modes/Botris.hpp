@@ -1,5 +1,6 @@
 #pragma once
 
+#include "./../RotationSystems.hpp"
 #include "./../ShaktrisConstants.hpp"
 #include <array>
 #include <algorithm>
@@ -11,10 +12,55 @@ struct Botris {
 	static constexpr int pc_bonus = 10;
 	static constexpr int b2b_bonus = 1;
 
-	std::size_t points(int linesCleared, spinType spin, bool pc, auto& combo, auto& b2b) {
+	// botris only turns left and right
+	static constexpr const KickTable180& kicks_180 = no_180_turns;
+
+	constexpr bool operator==(const Botris& other) const = default;
+
+	// combo and b2b are the values after the clear updated them
+	static constexpr std::size_t attack(int linesCleared, spinType spin, bool pc, std::size_t combo, bool b2b) {
 		std::size_t garbage = 0;
 
+		if (linesCleared) {
+			garbage += attack_table[static_cast<size_t>(linesCleared)];
+			if(spin == spinType::normal)
+				garbage += all_spin_bonus[static_cast<size_t>(linesCleared)];
+
+			// combo
+			garbage += combo_table[std::min(combo_table.size() - 1, combo)];
+
+			if (pc)
+				garbage += pc_bonus;
+			if (b2b)
+				garbage += b2b_bonus;
+		}
+
+		return garbage;
+	}
+
+	// the combo table tops out, so every clear fits and there is no fallback
+	static constexpr std::size_t table_index(int linesCleared, spinType spin, bool pc, std::size_t combo, bool b2b) {
+		return (((static_cast<std::size_t>(linesCleared) * 3 + static_cast<std::size_t>(spin)) * 2 + pc) * combo_table.size() + std::min(combo_table.size() - 1, combo)) * 2 + b2b;
+	}
+
+	using PointsTable = std::array<u8, attack_table.size() * 3 * 2 * combo_table.size() * 2>;
 
+	static consteval PointsTable make_points_table() {
+		PointsTable table{};
+		for (int lines = 0; lines < (int)attack_table.size(); ++lines)
+			for (int spin = 0; spin < 3; ++spin)
+				for (int pc = 0; pc < 2; ++pc)
+					for (std::size_t combo = 0; combo < combo_table.size(); ++combo)
+						for (int b2b = 0; b2b < 2; ++b2b)
+							table[table_index(lines, static_cast<spinType>(spin), pc, combo, b2b)] =
+								static_cast<u8>(attack(lines, static_cast<spinType>(spin), pc, combo, b2b));
+		return table;
+	}
+
+	// built right after the class, Botris has to be complete before attack() can run at compile time
+	static const PointsTable points_table;
+
+	std::size_t points(int linesCleared, spinType spin, bool pc, auto& combo, auto& b2b) {
 		if (linesCleared) {
 			auto maintainsB2B = false;
 			combo++;
@@ -30,21 +76,8 @@ struct Botris {
 			combo = 0;
 		}
 
-		if (linesCleared) {
-			garbage += attack_table[static_cast<size_t>(linesCleared)];
-			if(spin == spinType::normal)
-				garbage += all_spin_bonus[static_cast<size_t>(linesCleared)];
-
-			// combo
-			garbage += combo_table[std::min(combo_table.size() - 1, static_cast<size_t>(combo))];
-
-			if (pc)
-				garbage += pc_bonus;
-			if (b2b)
-				garbage += b2b_bonus;
-		}
-
-
-		return garbage;
+		return points_table[table_index(linesCleared, spin, pc, static_cast<std::size_t>(combo), static_cast<bool>(b2b))];
 	}
-};
\ No newline at end of file
+};
+
+inline constexpr Botris::PointsTable Botris::points_table = Botris::make_points_table();
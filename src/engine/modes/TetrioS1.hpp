@@ -1,5 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "./../RotationSystems.hpp"
+#include "./../ShaktrisConstants.hpp"
+#include "./../../util/constexpr_math.hpp"
 
 // points callable concept is satisfied by the TetrioS1 struct
 class TetrioS1 {
@@ -37,32 +45,53 @@ public:
     u16 currentcombopower = 0;
     u16 currentbtbchainpower = 0;
 
+    bool operator==(const TetrioS1& other) const = default;
+
     static struct options {
         static constexpr u8 garbagemultiplier = 1;
         static constexpr bool b2bchaining = true;
     } options;
 
+    // srs+ 180s
+    static constexpr const KickTable180& kicks_180 = tetrio_180_kicks;
 
-    // points function
-    std::size_t points(int linesCleared, spinType spin, bool pc, auto&combo, auto&b2b) {
-        auto maintainsB2B = false;
 
-        if (linesCleared) {
-            combo++;
-            if (4 == linesCleared || spin != spinType::null)
-                maintainsB2B = true;
+    // what a clear is worth before the all clear bonus, and the b2b chain bonus inside of it
+    struct Attack {
+        int garbage;
+        int b2b_garbage;
+    };
 
-            if (maintainsB2B)
-                b2b++;
-            else
-                b2b = 0;
+    // std::log1p at runtime, the constexpr one while building the tables
+    static constexpr float log1p(float x) {
+        if consteval {
+            return constexpr_log1p(x);
         }
         else {
-            combo = 0;
-            currentcombopower = 0;
+            return std::log1p(x);
         }
-
+    }
+
+    // b2b chain bonus, only used once b2b is past 1
+    static constexpr int chain_bonus(int b2b) {
+        return GarbageValues::BACKTOBACK_BONUS *
+            (1 + log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG) + (b2b - 1 <= 1 ? 0 : (1 + log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG) - (int)log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG)) / 3));
+    }
+
+    // the least a clear sends once combo is past 2
+    static constexpr int combo_minimum(int combo) {
+        return (int)log1p(GarbageValues::COMBO_MINIFIER * (combo - 1) * GarbageValues::COMBO_MINIFIER_LOG);
+    }
+
+    // combo and b2b are the values after the clear updated them
+    static constexpr Attack attack(int linesCleared, spinType spin, int combo, int b2b) {
+        return attack(linesCleared, spin, combo, b2b, chain_bonus(b2b), combo_minimum(combo));
+    }
+
+    // same thing with the log1p parts passed in, so the tables only work those out once per b2b and combo
+    static constexpr Attack attack(int linesCleared, spinType spin, int combo, int b2b, int chain, int minimum) {
         int garbage = 0;
+        int b2bGarbage = 0;
 
         switch (linesCleared) {
         case 0:
@@ -109,22 +138,13 @@ public:
         if (linesCleared) {
             if (b2b > 1) {
                 if (options.b2bchaining) {
-                    const int b2bGarbage = GarbageValues::BACKTOBACK_BONUS *
-                        (1 + std::log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG) + (b2b - 1 <= 1 ? 0 : (1 + std::log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG) - (int)std::log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG)) / 3));
+                    b2bGarbage = chain;
 
                     garbage += b2bGarbage;
-
-                    if (b2bGarbage > currentbtbchainpower)
-                        currentbtbchainpower = b2bGarbage;
-
                 }
                 else
                     garbage += GarbageValues::BACKTOBACK_BONUS;
-
             }
-            else
-                currentbtbchainpower = 0;
-
         }
 
         if (combo > 1)
@@ -132,10 +152,91 @@ public:
 
 
         if (combo > 2) 
-            garbage = std::max((int)std::log1p(GarbageValues::COMBO_MINIFIER * (combo - 1) * GarbageValues::COMBO_MINIFIER_LOG), garbage);
+            garbage = std::max(minimum, garbage);
+
+        return { garbage * options.garbagemultiplier, b2bGarbage };
+    }
+
+    // every clear a real game gets to, anything past this goes through attack() instead
+    static constexpr int table_combo = 24;
+    static constexpr int table_b2b = 48;
+    static constexpr int table_spins = 3;
+    static constexpr int table_lines = 5;
+
+    static constexpr std::size_t table_index(int linesCleared, spinType spin, int combo, int b2b) {
+        return ((static_cast<std::size_t>(linesCleared) * table_spins + static_cast<std::size_t>(spin)) * table_combo + combo) * table_b2b + b2b;
+    }
+
+    using AttackTable = std::array<u8, table_lines * table_spins * table_combo * table_b2b>;
+    using B2BTable = std::array<u8, table_b2b>;
+
+    static consteval B2BTable make_b2b_table() {
+        B2BTable table{};
+        for (int b2b = 2; b2b < table_b2b; ++b2b)
+            table[b2b] = static_cast<u8>(chain_bonus(b2b));
+        return table;
+    }
+
+    static consteval AttackTable make_attack_table() {
+        const B2BTable chain = make_b2b_table();
+        std::array<int, table_combo> minimum{};
+        for (int combo = 3; combo < table_combo; ++combo)
+            minimum[combo] = combo_minimum(combo);
+
+        AttackTable table{};
+        for (int lines = 0; lines < table_lines; ++lines)
+            for (int spin = 0; spin < table_spins; ++spin)
+                for (int combo = 0; combo < table_combo; ++combo)
+                    for (int b2b = 0; b2b < table_b2b; ++b2b)
+                        table[table_index(lines, static_cast<spinType>(spin), combo, b2b)] =
+                            static_cast<u8>(attack(lines, static_cast<spinType>(spin), combo, b2b, chain[b2b], minimum[combo]).garbage);
+        return table;
+    }
+
+    // built right after the class, TetrioS1 has to be complete before attack() can run at compile time
+    static const AttackTable attack_table;
+    static const B2BTable b2b_table;
 
+    // points function
+    std::size_t points(int linesCleared, spinType spin, bool pc, auto&combo, auto&b2b) {
+        auto maintainsB2B = false;
+
+        if (linesCleared) {
+            combo++;
+            if (4 == linesCleared || spin != spinType::null)
+                maintainsB2B = true;
+
+            if (maintainsB2B)
+                b2b++;
+            else
+                b2b = 0;
+        }
+        else {
+            combo = 0;
+            currentcombopower = 0;
+        }
+
+        int finalGarbage;
+        int b2bGarbage;
+        if (combo < table_combo && b2b < table_b2b) [[likely]] {
+            finalGarbage = attack_table[table_index(linesCleared, spin, combo, b2b)];
+            b2bGarbage = b2b_table[b2b];
+        }
+        else {
+            const Attack attack = TetrioS1::attack(linesCleared, spin, (int)combo, (int)b2b);
+            finalGarbage = attack.garbage;
+            b2bGarbage = attack.b2b_garbage;
+        }
+
+        if (linesCleared) {
+            if (b2b > 1) {
+                if (b2bGarbage > currentbtbchainpower)
+                    currentbtbchainpower = b2bGarbage;
+            }
+            else
+                currentbtbchainpower = 0;
+        }
 
-        const int finalGarbage = garbage * options.garbagemultiplier;
         if (combo > 2)
             currentcombopower = std::max((int)currentcombopower, finalGarbage);
 
@@ -143,4 +244,7 @@ public:
 
         return combinedGarbage;
 	}
-};
\ No newline at end of file
+};
+
+inline constexpr TetrioS1::AttackTable TetrioS1::attack_table = TetrioS1::make_attack_table();
+inline constexpr TetrioS1::B2BTable TetrioS1::b2b_table = TetrioS1::make_b2b_table();
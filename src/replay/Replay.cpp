@@ -0,0 +1,147 @@
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SHAKTRIS_REPLAY_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool ReplayWriter::open_file(const char* path) {
+    close();
+    file = std::fopen(path, "wb");
+    failed = file == nullptr;
+    used = 0;
+    return file != nullptr;
+}
+
+void ReplayWriter::write(const void* data, std::size_t size) {
+    const std::byte* bytes = static_cast<const std::byte*>(data);
+    while (size > 0) {
+        if (used == buffer.size())
+            flush();
+        const std::size_t n = std::min(size, buffer.size() - used);
+        std::memcpy(buffer.data() + used, bytes, n);
+        used += n;
+        bytes += n;
+        size -= n;
+    }
+}
+
+void ReplayWriter::flush() {
+    if (file && used && std::fwrite(buffer.data(), 1, used, file) != used)
+        failed = true;
+    used = 0;
+}
+
+bool ReplayWriter::close() {
+    if (!file)
+        return !failed;
+
+    flush();
+    failed |= std::fclose(file) != 0;
+    file = nullptr;
+    return !failed;
+}
+
+bool ReplayReader::open(const char* path) {
+    close();
+
+#ifdef SHAKTRIS_REPLAY_MMAP
+    const int fd = ::open(path, O_RDONLY);
+    if (fd >= 0) {
+        // a failed fstat leaves info unset, then data stays empty and the stream below reads the file
+        struct stat info;
+        const bool sized = ::fstat(fd, &info) == 0;
+        if (sized && info.st_size >= static_cast<off_t>(mmap_threshold)) {
+            void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const std::byte*>(mapping);
+                size = static_cast<std::size_t>(info.st_size);
+                mapped = true;
+            }
+        }
+        else if (sized && info.st_size > 0) {
+            // mapping and unmapping costs more than copying a file this small, most games are
+            contents.resize(static_cast<std::size_t>(info.st_size));
+            std::size_t read = 0;
+            while (read < contents.size()) {
+                const ssize_t n = ::read(fd, contents.data() + read, contents.size() - read);
+                if (n <= 0)
+                    break;
+                read += static_cast<std::size_t>(n);
+            }
+            if (read == contents.size()) {
+                data = contents.data();
+                size = contents.size();
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    // no mmap, or it failed, read the whole thing instead
+    if (!data) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in)
+            return false;
+        contents.resize(static_cast<std::size_t>(in.tellg()));
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(contents.data()), static_cast<std::streamsize>(contents.size())))
+            return false;
+        data = contents.data();
+        size = contents.size();
+    }
+
+    if (size < sizeof(ReplayHeader)) {
+        close();
+        return false;
+    }
+    std::memcpy(&head, data, sizeof(head));
+    if (head.magic != ReplayHeader::expected_magic || head.version != ReplayHeader::current_version) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void ReplayReader::close() {
+#ifdef SHAKTRIS_REPLAY_MMAP
+    if (mapped)
+        ::munmap(const_cast<std::byte*>(data), size);
+#endif
+    mapped = false;
+    contents.clear();
+    data = nullptr;
+    size = 0;
+}
+
+u64 ReplayReader::turns() const {
+    if (!data)
+        return 0;
+
+    const std::size_t body = size - sizeof(ReplayHeader);
+    if (!head.keyframe_interval)
+        return body / sizeof(ReplayTurn);
+
+    const u64 blocks = body / block_size();
+    const u64 rest = (body % block_size()) / sizeof(ReplayTurn);
+    return blocks * head.keyframe_interval + std::min<u64>(rest, head.keyframe_interval);
+}
+
+u64 ReplayReader::keyframes() const {
+    if (!data || !head.keyframe_interval)
+        return 0;
+    return (size - sizeof(ReplayHeader)) / block_size();
+}
+
+ReplayTurn ReplayReader::turn(u64 t) const {
+    ReplayTurn ret;
+    std::memcpy(&ret, data + turn_offset(t), sizeof(ret));
+    return ret;
+}
@@ -0,0 +1,327 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "VersusGame.hpp"
+#include "engine/GameState.hpp"
+#include "engine/Placement.hpp"
+#include "util/hash.hpp"
+#include "util/randomizer.hpp"
+#include "util/rng.hpp"
+
+// binary replays of a VersusGame
+//
+// header | block | block | ...
+// block = keyframe_interval turns, then a keyframe of the state after them
+// turn = p1 placement | p2 placement | 16 bits of the game hashes after the turn, 6 bytes
+//
+// every block is the same size so any turn or keyframe is found with a multiply, without an index
+// a keyframe interval of 0 means no keyframes, the turns just follow the header and everything replays from the seeds
+// integers are stored little endian as they are in memory, keyframes are the raw bytes of ReplayKeyframe
+static_assert(std::endian::native == std::endian::little, "replays are written in memory order");
+
+// tag of the randomizer the replay needs, keyframes store its raw state
+template <class R>
+constexpr u8 replay_randomizer_tag = 0xff;
+template <>
+inline constexpr u8 replay_randomizer_tag<RNG> = 0;
+template <>
+inline constexpr u8 replay_randomizer_tag<CounterRNG> = 1;
+template <>
+inline constexpr u8 replay_randomizer_tag<Bag14> = 2;
+template <>
+inline constexpr u8 replay_randomizer_tag<PureRandom> = 3;
+template <>
+inline constexpr u8 replay_randomizer_tag<NesReroll> = 4;
+
+struct ReplayHeader {
+    static constexpr std::array<char, 4> expected_magic = { 'S', 'H', 'K', 'R' };
+    static constexpr u16 current_version = 1;
+
+    std::array<char, 4> magic = expected_magic;
+    u16 version = current_version;
+    u8 randomizer = 0;
+    // index inside GameModes of each player's mode
+    u8 p1_mode = 0;
+    u8 p2_mode = 0;
+    u8 reserved0 = 0;
+    u16 reserved1 = 0;
+    u32 p1_seed = 0;
+    u32 p2_seed = 0;
+    u32 keyframe_interval = 0;
+    // sizeof(ReplayKeyframe) when it was written, a reader built differently refuses the file
+    u32 keyframe_size = 0;
+};
+
+static_assert(sizeof(ReplayHeader) == 28 && std::is_trivially_copyable_v<ReplayHeader>, "replay header layout changed");
+
+struct ReplayTurn {
+    // what play_moves stores for a player that did not move
+    static constexpr u16 null_move = 0xffff;
+
+    u16 p1 = null_move;
+    u16 p2 = null_move;
+    u16 check = 0;
+
+    static Move move(u16 placement) {
+        if (placement == null_move)
+            return Move(Piece(PieceType::Empty), true);
+        return Move(Placement::from_raw(placement).to_piece(), false);
+    }
+
+    static u16 placement(const Move& move) {
+        return move.null_move ? null_move : Placement(move.piece).raw();
+    }
+};
+
+static_assert(sizeof(ReplayTurn) == 6, "replay turns should be 6 bytes");
+
+// hash of both players after a turn, folded to 16 bits
+template <randomizer Randomizer>
+inline u16 replay_check(const BasicVersusGame<Randomizer>& game) {
+    const u64 h = hash_combine(game.p1_game.hash(), game.p2_game.hash());
+    return static_cast<u16>(h ^ (h >> 16) ^ (h >> 32) ^ (h >> 48));
+}
+
+// everything play_moves reads, so replaying can start from here
+template <randomizer Randomizer>
+struct ReplayKeyframe {
+    static_assert(std::is_trivially_copyable_v<Randomizer>, "keyframes store the randomizer as raw bytes");
+
+    std::array<GameState, 2> games;
+    // raw bytes, randomizers are not all default constructible and RNG's default constructor reads random_device
+    std::array<std::array<std::byte, sizeof(Randomizer)>, 2> rngs;
+    std::array<double, 2> atk;
+    std::array<i32, 2> meter;
+    i32 turn;
+    u8 game_over;
+
+    static ReplayKeyframe from(const BasicVersusGame<Randomizer>& game) {
+        // padding goes to disk too, so it has to be zero for the same game to give the same bytes
+        ReplayKeyframe ret;
+        std::memset(static_cast<void*>(&ret), 0, sizeof(ret));
+        ret.games = { GameState::from(game.p1_game), GameState::from(game.p2_game) };
+        std::memcpy(ret.rngs[0].data(), &game.p1_rng, sizeof(Randomizer));
+        std::memcpy(ret.rngs[1].data(), &game.p2_rng, sizeof(Randomizer));
+        ret.atk = { game.p1_atk, game.p2_atk };
+        ret.meter = { game.p1_meter, game.p2_meter };
+        ret.turn = game.turn;
+        ret.game_over = game.game_over;
+        return ret;
+    }
+
+    // everything but the recorder, the moves are cleared like they are in a new game
+    void restore(BasicVersusGame<Randomizer>& game) const {
+        game.p1_move = game.p2_move = Move(Piece(PieceType::Empty), false);
+        game.p1_game = games[0].to_game();
+        game.p2_game = games[1].to_game();
+        std::memcpy(static_cast<void*>(&game.p1_rng), rngs[0].data(), sizeof(Randomizer));
+        std::memcpy(static_cast<void*>(&game.p2_rng), rngs[1].data(), sizeof(Randomizer));
+        game.p1_atk = atk[0];
+        game.p2_atk = atk[1];
+        game.p1_meter = meter[0];
+        game.p2_meter = meter[1];
+        game.turn = turn;
+        game.game_over = game_over;
+    }
+};
+
+// streams a game to a file as it is played, set it as the game's recorder and every play_moves lands here
+// turns go through a fixed buffer so recording never allocates
+class ReplayWriter {
+   public:
+    ReplayWriter() = default;
+    ~ReplayWriter() {
+        close();
+    }
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    // game has to be fresh from BasicVersusGame(p1_seed, p2_seed), with its modes already set
+    template <randomizer Randomizer>
+    bool open(const char* path, const BasicVersusGame<Randomizer>& game, u32 p1_seed, u32 p2_seed, u32 keyframe_interval) {
+        ReplayHeader header;
+        header.randomizer = replay_randomizer_tag<Randomizer>;
+        header.p1_mode = static_cast<u8>(game.p1_game.mode_index());
+        header.p2_mode = static_cast<u8>(game.p2_game.mode_index());
+        header.p1_seed = p1_seed;
+        header.p2_seed = p2_seed;
+        header.keyframe_interval = keyframe_interval;
+        header.keyframe_size = sizeof(ReplayKeyframe<Randomizer>);
+
+        if (!open_file(path))
+            return false;
+        interval = keyframe_interval;
+        turns = 0;
+        write(&header, sizeof(header));
+        return !failed;
+    }
+
+    // the turn game just played
+    template <randomizer Randomizer>
+    void record(const BasicVersusGame<Randomizer>& game) {
+        const ReplayTurn turn{ ReplayTurn::placement(game.p1_move), ReplayTurn::placement(game.p2_move), replay_check(game) };
+        write(&turn, sizeof(turn));
+
+        turns++;
+        if (interval && turns % interval == 0) {
+            const ReplayKeyframe<Randomizer> keyframe = ReplayKeyframe<Randomizer>::from(game);
+            write(&keyframe, sizeof(keyframe));
+        }
+    }
+
+    // flushes and closes, false if anything failed to write
+    bool close();
+
+    bool is_open() const {
+        return file != nullptr;
+    }
+
+    u64 turns_written() const {
+        return turns;
+    }
+
+   private:
+    bool open_file(const char* path);
+    void write(const void* data, std::size_t size);
+    void flush();
+
+    std::FILE* file = nullptr;
+    bool failed = false;
+    u32 interval = 0;
+    u64 turns = 0;
+    std::size_t used = 0;
+    std::array<std::byte, 1 << 16> buffer;
+};
+
+// reads a replay, memory mapped where the platform has it and the file is big enough, read into memory otherwise
+// any turn's state is rebuilt from the keyframe before it, so random access costs at most keyframe_interval turns
+class ReplayReader {
+   public:
+    ReplayReader() = default;
+    ~ReplayReader() {
+        close();
+    }
+
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    // false if the file can not be read or is not a replay this build understands
+    bool open(const char* path);
+    void close();
+
+    const ReplayHeader& header() const {
+        return head;
+    }
+
+    // complete turns in the file, a recording cut off halfway still reads up to its last whole turn
+    u64 turns() const;
+
+    // turn t, counting from 0
+    ReplayTurn turn(u64 t) const;
+
+    // keyframes that made it into the file whole
+    u64 keyframes() const;
+
+    // keyframe k, the state after (k + 1) * keyframe_interval turns
+    // false if the file was written with another randomizer or there is no such keyframe
+    template <randomizer Randomizer>
+    bool keyframe(u64 k, ReplayKeyframe<Randomizer>& out) const {
+        if (head.randomizer != replay_randomizer_tag<Randomizer> || head.keyframe_size != sizeof(ReplayKeyframe<Randomizer>) ||
+            k >= keyframes())
+            return false;
+        std::memcpy(static_cast<void*>(&out), data + keyframe_offset(k), sizeof(out));
+        return true;
+    }
+
+    std::span<const std::byte> bytes() const {
+        return { data, size };
+    }
+
+    // game after the first turns turns, checking every replayed turn against its stored hash when verify is set
+    // false if the randomizer does not match the file, the keyframe to start from can not be read, or a turn did not replay to the same position
+    template <randomizer Randomizer>
+    bool state_at(u64 turns_played, BasicVersusGame<Randomizer>& out, bool verify = true) const {
+        if (head.randomizer != replay_randomizer_tag<Randomizer> || head.keyframe_size != sizeof(ReplayKeyframe<Randomizer>) ||
+            turns_played > turns())
+            return false;
+
+        // the keyframe after block b holds the state after (b + 1) * keyframe_interval turns
+        const u64 block = head.keyframe_interval ? std::min<u64>(turns_played / head.keyframe_interval, keyframes()) : 0;
+        const u64 start = block * head.keyframe_interval;
+
+        ReplayWriter* const recorder = out.recorder;
+        if (block > 0) {
+            ReplayKeyframe<Randomizer> stored;
+            if (!keyframe(block - 1, stored))
+                return false;
+            stored.restore(out);
+        }
+        else {
+            out = initial<Randomizer>();
+        }
+        // replaying should not record the turns again
+        out.recorder = nullptr;
+
+        for (u64 t = start; t < turns_played; ++t) {
+            const ReplayTurn record = turn(t);
+            out.set_move(0, ReplayTurn::move(record.p1));
+            out.set_move(1, ReplayTurn::move(record.p2));
+            out.play_moves();
+            if (verify && replay_check(out) != record.check) {
+                out.recorder = recorder;
+                return false;
+            }
+        }
+        out.recorder = recorder;
+        return true;
+    }
+
+   private:
+    template <randomizer Randomizer>
+    BasicVersusGame<Randomizer> initial() const {
+        BasicVersusGame<Randomizer> game(head.p1_seed, head.p2_seed);
+        // a fresh game only differs from its GameState in the mode
+        GameState p1 = GameState::from(game.p1_game);
+        GameState p2 = GameState::from(game.p2_game);
+        p1.mode = head.p1_mode;
+        p2.mode = head.p2_mode;
+        game.p1_game = p1.to_game();
+        game.p2_game = p2.to_game();
+        return game;
+    }
+
+    std::size_t block_size() const {
+        return head.keyframe_interval * sizeof(ReplayTurn) + head.keyframe_size;
+    }
+
+    std::size_t turn_offset(u64 t) const {
+        if (!head.keyframe_interval)
+            return sizeof(ReplayHeader) + t * sizeof(ReplayTurn);
+        return sizeof(ReplayHeader) + (t / head.keyframe_interval) * block_size() + (t % head.keyframe_interval) * sizeof(ReplayTurn);
+    }
+
+    std::size_t keyframe_offset(u64 block) const {
+        return sizeof(ReplayHeader) + block * block_size() + head.keyframe_interval * sizeof(ReplayTurn);
+    }
+
+    ReplayHeader head;
+    const std::byte* data = nullptr;
+    std::size_t size = 0;
+
+    // files smaller than this are read instead of mapped
+    static constexpr std::size_t mmap_threshold = 1 << 16;
+
+    // set when the file is mapped, otherwise data points into contents
+    bool mapped = false;
+    std::vector<std::byte> contents;
+};
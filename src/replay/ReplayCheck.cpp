@@ -0,0 +1,124 @@
+#include "ReplayCheck.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+#include "Replay.hpp"
+#include "util/randomizer.hpp"
+#include "util/rng.hpp"
+
+namespace {
+
+    // plays the whole recording from the seeds, keyframes are only compared against, never restored from
+    template <randomizer Randomizer>
+    ReplayCheckResult check(const ReplayReader& reader) {
+        ReplayCheckResult result;
+
+        // state_at starts from the seeds and modes in the header, the seed given here is thrown away
+        BasicVersusGame<Randomizer> game(0u);
+        if (!reader.state_at(0, game, false))
+            return result;
+        result.readable = true;
+
+        const u64 interval = reader.header().keyframe_interval;
+        const u64 keyframes = reader.keyframes();
+        const u64 turns = reader.turns();
+        for (u64 t = 0; t < turns; ++t) {
+            const ReplayTurn record = reader.turn(t);
+            game.set_move(0, ReplayTurn::move(record.p1));
+            game.set_move(1, ReplayTurn::move(record.p2));
+            game.play_moves();
+
+            bool matches = replay_check(game) == record.check;
+            if (matches && interval && (t + 1) % interval == 0 && (t + 1) / interval <= keyframes) {
+                ReplayKeyframe<Randomizer> stored;
+                reader.keyframe((t + 1) / interval - 1, stored);
+                const ReplayKeyframe<Randomizer> replayed = ReplayKeyframe<Randomizer>::from(game);
+                // field by field, padding bytes are not part of the state
+                matches = stored.games == replayed.games && stored.rngs == replayed.rngs && stored.atk == replayed.atk &&
+                    stored.meter == replayed.meter && stored.turn == replayed.turn && stored.game_over == replayed.game_over;
+            }
+            if (!matches) {
+                result.divergence = static_cast<std::int64_t>(t);
+                break;
+            }
+
+            result.turns++;
+            for (int id = 0; id < 2; ++id)
+                result.max_b2b[id] = std::max<u16>(result.max_b2b[id], static_cast<u16>(game.get_b2b(id)));
+        }
+
+        if (game.turn > 0) {
+            result.app[0] = game.get_app(0);
+            result.app[1] = game.get_app(1);
+        }
+        result.attack[0] = game.p1_atk;
+        result.attack[1] = game.p2_atk;
+        if (game.game_over)
+            result.outcome = game.get_winner();
+        return result;
+    }
+
+};
+
+ReplayCheckResult check_replay(const char* path) {
+    ReplayReader reader;
+    if (!reader.open(path))
+        return {};
+
+    switch (reader.header().randomizer) {
+        case replay_randomizer_tag<RNG>:
+            return check<RNG>(reader);
+        case replay_randomizer_tag<CounterRNG>:
+            return check<CounterRNG>(reader);
+        case replay_randomizer_tag<Bag14>:
+            return check<Bag14>(reader);
+        case replay_randomizer_tag<PureRandom>:
+            return check<PureRandom>(reader);
+        case replay_randomizer_tag<NesReroll>:
+            return check<NesReroll>(reader);
+        default:
+            return {};
+    }
+}
+
+ReplayCheckStats check_replays(ThreadPool& pool, std::span<const std::string> paths, std::span<ReplayCheckResult> results) {
+    auto time_start = std::chrono::steady_clock::now();
+    // files differ a lot in length, one per task lets the idle workers steal the stragglers
+    parallel_for(pool, 0, paths.size(), 1, [&](std::size_t i) {
+        results[i] = check_replay(paths[i].c_str());
+    });
+
+    ReplayCheckStats stats;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+    stats.files = paths.size();
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        const ReplayCheckResult& result = results[i];
+        if (!result.readable) {
+            stats.unreadable++;
+            continue;
+        }
+        if (result.divergence >= 0)
+            stats.diverged++;
+
+        stats.turns += result.turns;
+        for (int id = 0; id < 2; ++id) {
+            stats.attack[id] += result.attack[id];
+            stats.max_b2b[id] = std::max(stats.max_b2b[id], result.max_b2b[id]);
+        }
+        switch (result.outcome) {
+            case Outcomes::P1_WIN:
+                stats.p1_wins++;
+                break;
+            case Outcomes::P2_WIN:
+                stats.p2_wins++;
+                break;
+            case Outcomes::DRAW:
+                stats.draws++;
+                break;
+            case Outcomes::NONE:
+                break;
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+#include "VersusGame.hpp"
+#include "engine/ShaktrisConstants.hpp"
+#include "util/threadpool.hpp"
+
+// replays recorded games through the current engine and checks they still play out the same
+// every turn is checked against the 16 bit hash stored with it and every keyframe against the whole stored state
+
+struct ReplayCheckResult {
+    // false if the file could not be opened or was written with a randomizer this build does not know
+    bool readable = false;
+    u64 turns = 0;
+    // first turn whose position did not match the recording, -1 if every turn did
+    // replaying stops there, everything after it would differ anyway
+    std::int64_t divergence = -1;
+    Outcomes outcome = Outcomes::NONE;
+
+    double app[2] = { 0, 0 };
+    double attack[2] = { 0, 0 };
+    u16 max_b2b[2] = { 0, 0 };
+
+    bool ok() const {
+        return readable && divergence < 0;
+    }
+};
+
+// totals over a set of replays
+struct ReplayCheckStats {
+    std::size_t files = 0;
+    std::size_t unreadable = 0;
+    std::size_t diverged = 0;
+
+    std::size_t p1_wins = 0;
+    std::size_t p2_wins = 0;
+    std::size_t draws = 0;
+
+    u64 turns = 0;
+    double attack[2] = { 0, 0 };
+    u16 max_b2b[2] = { 0, 0 };
+    double seconds = 0;
+
+    // attack per piece over every replayed turn
+    double app(int id) const {
+        return turns == 0 ? 0 : attack[id] / turns;
+    }
+
+    double turns_per_second() const {
+        return seconds == 0 ? 0 : turns / seconds;
+    }
+};
+
+ReplayCheckResult check_replay(const char* path);
+
+// checks every file on the pool, one file per task, results[i] is paths[i]
+ReplayCheckStats check_replays(ThreadPool& pool, std::span<const std::string> paths, std::span<ReplayCheckResult> results);
@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "ReplayCheck.hpp"
+#include "util/threadpool.hpp"
+
+// re-simulates replays with the current engine, prints every file that no longer plays out the same and the totals
+// usage: ShakTrisReplayCheck [--threads N] replay...
+// exits with 1 if any replay diverged or could not be read
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            const std::string_view value = argv[++i];
+            std::from_chars(value.data(), value.data() + value.size(), threads);
+            continue;
+        }
+        paths.emplace_back(arg);
+    }
+
+    if (paths.empty()) {
+        std::fprintf(stderr, "usage: %s [--threads N] replay...\n", argv[0]);
+        return 2;
+    }
+
+    ThreadPool pool(std::max(1u, threads));
+    std::vector<ReplayCheckResult> results(paths.size());
+    const ReplayCheckStats stats = check_replays(pool, paths, results);
+
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        if (!results[i].readable)
+            std::printf("%s: unreadable\n", paths[i].c_str());
+        else if (results[i].divergence >= 0)
+            std::printf("%s: diverged at turn %lld\n", paths[i].c_str(), static_cast<long long>(results[i].divergence));
+    }
+
+    std::printf("files: %zu\tdiverged: %zu\tunreadable: %zu\n", stats.files, stats.diverged, stats.unreadable);
+    std::printf("turns: %llu\t%.0f turns/s on %zu threads\n", static_cast<unsigned long long>(stats.turns), stats.turns_per_second(), pool.size());
+    std::printf("p1 wins: %zu\tp2 wins: %zu\tdraws: %zu\n", stats.p1_wins, stats.p2_wins, stats.draws);
+    std::printf("app p1: %.3f\tp2: %.3f\tmax b2b p1: %u\tp2: %u\n", stats.app(0), stats.app(1), unsigned(stats.max_b2b[0]), unsigned(stats.max_b2b[1]));
+
+    return stats.diverged == 0 && stats.unreadable == 0 ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+#include "AnytimeSearch.hpp"
+
+#include <algorithm>
+
+#include "engine/Utility.hpp"
+
+namespace Shaktris {
+    namespace Search {
+
+        bool AnytimeSearch::out_of_time(const std::stop_token& stop) const {
+            return stop.stop_requested() ||
+                clock::now().time_since_epoch().count() >= deadline_ticks.load(std::memory_order_relaxed);
+        }
+
+        // plays the move on a copy of the node and queues the child for the next layer
+        void AnytimeSearch::expand(const Node& node, const Piece& move, u16 root_move) {
+            Node child{ node.game, 0, node.attack, root_move };
+            Game& game = child.game;
+
+            const spinType spin = move.spin;
+            game.place_piece(move);
+            const int lines_cleared = game.board.clearLines();
+            const int damage = game.damage_sent(lines_cleared, spin, game.board.is_empty());
+
+            // topping out is never worth it
+            if (game.current_piece.type != PieceType::Empty &&
+                Shaktris::Utility::collides(game.board, game.current_piece))
+                return;
+
+            child.attack += damage;
+            child.score = evaluator(game) + limits.attack_weight * child.attack;
+            next_layer.push_back(child);
+        }
+
+        void AnytimeSearch::prune(std::vector<Node>& nodes, std::size_t width) const {
+            if (nodes.size() <= width)
+                return;
+
+            std::nth_element(nodes.begin(), nodes.begin() + width, nodes.end(),
+                [](const Node& a, const Node& b) { return a.score > b.score; });
+            nodes.resize(width);
+        }
+
+        SearchResult AnytimeSearch::run(const Game& root, std::stop_token stop, bool publish) {
+            SearchResult best;
+
+            if (root.current_piece.type == PieceType::Empty)
+                return best;
+
+            root_moves.clear();
+            root.get_possible_placements(root_moves);
+            if (root_moves.empty())
+                return best;
+
+            // the first layer is always searched completely, that way there is a move to return
+            // even if the deadline is already close
+            const Node root_node{ root, 0, 0, 0 };
+            next_layer.clear();
+            for (size_t m = 0; m < root_moves.size(); ++m)
+                expand(root_node, root_moves[m].to_piece(), (u16)m);
+            best.nodes += root_moves.size();
+
+            if (next_layer.empty()) {
+                best.best = root_moves.front().to_piece();
+                if (publish) {
+                    std::lock_guard lock(result_lock);
+                    ponder_result = best;
+                }
+                return best;
+            }
+
+            std::swap(first_layer, next_layer);
+            {
+                auto greedy = std::max_element(first_layer.begin(), first_layer.end(),
+                    [](const Node& a, const Node& b) { return a.score < b.score; });
+                best.best = root_moves[greedy->root_move].to_piece();
+                best.score = greedy->score;
+                best.depth = 1;
+            }
+
+            if (publish) {
+                std::lock_guard lock(result_lock);
+                ponder_result = best;
+            }
+
+            for (std::size_t width = limits.initial_width; width <= limits.max_width; width *= 2) {
+                // the best width nodes to the front, the first layer is only reordered so the next iteration can do it again
+                const std::size_t kept = std::min(width, first_layer.size());
+                if (kept < first_layer.size())
+                    std::nth_element(first_layer.begin(), first_layer.begin() + kept, first_layer.end(),
+                        [](const Node& a, const Node& b) { return a.score > b.score; });
+                layer.assign(first_layer.begin(), first_layer.begin() + kept);
+
+                int depth = 1;
+                bool aborted = false;
+
+                while (true) {
+                    next_layer.clear();
+                    bool expanded = false;
+
+                    for (const Node& node : layer) {
+                        if (out_of_time(stop)) {
+                            aborted = true;
+                            break;
+                        }
+
+                        // ran out of queue, keep the leaf around so it competes with deeper nodes
+                        if (node.game.current_piece.type == PieceType::Empty) {
+                            next_layer.push_back(node);
+                            continue;
+                        }
+
+                        moves.clear();
+                        node.game.get_possible_placements(moves);
+
+                        // a node has up to a couple hundred children, so the clock is checked on the way through them too
+                        const std::size_t before = next_layer.size();
+                        for (std::size_t m = 0; m < moves.size(); ++m) {
+                            if (m % deadline_check_interval == deadline_check_interval - 1 && out_of_time(stop)) {
+                                aborted = true;
+                                break;
+                            }
+                            expand(node, moves[m].to_piece(), node.root_move);
+                        }
+
+                        best.nodes += next_layer.size() - before;
+                        // pruning as the layer grows keeps every nth_element short, one over the whole layer can take longer than the stop budget
+                        if (next_layer.size() >= 2 * width)
+                            prune(next_layer, width);
+                        expanded = true;
+                        if (aborted)
+                            break;
+                    }
+
+                    if (aborted || !expanded || next_layer.empty())
+                        break;
+
+                    prune(next_layer, width);
+                    std::swap(layer, next_layer);
+                    depth++;
+                }
+
+                if (aborted)
+                    break;
+
+                const auto leader = std::max_element(layer.begin(), layer.end(),
+                    [](const Node& a, const Node& b) { return a.score < b.score; });
+                best.best = root_moves[leader->root_move].to_piece();
+                best.score = leader->score;
+                best.width = width;
+                best.depth = depth;
+
+                if (publish) {
+                    std::lock_guard lock(result_lock);
+                    ponder_result = best;
+                }
+
+                if (out_of_time(stop))
+                    break;
+            }
+
+            return best;
+        }
+
+        SearchResult AnytimeSearch::search(const Game& root, clock::time_point deadline, std::stop_token stop) {
+            stop_pondering();
+            deadline_ticks.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+            return run(root, stop, false);
+        }
+
+        void AnytimeSearch::ponder(const VersusGame& predicted, int id) {
+            stop_pondering();
+
+            const Game& game = predicted.get_game(id);
+            ponder_game = game;
+            ponder_result = {};
+            deadline_ticks.store(clock::time_point::max().time_since_epoch().count(), std::memory_order_relaxed);
+
+            ponder_thread = std::jthread([this, game](std::stop_token stop) {
+                run(game, stop, true);
+            });
+        }
+
+        SearchResult AnytimeSearch::ponder_hit(const VersusGame& actual, int id, clock::time_point deadline) {
+            const Game& game = actual.get_game(id);
+
+            if (ponder_thread.joinable() && game == ponder_game) {
+                // the pondering search picks the deadline up the next time it looks at the clock
+                deadline_ticks.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+                ponder_thread.join();
+
+                std::lock_guard lock(result_lock);
+                return ponder_result;
+            }
+
+            return search(game, deadline);
+        }
+
+        void AnytimeSearch::stop_pondering() {
+            if (ponder_thread.joinable()) {
+                ponder_thread.request_stop();
+                ponder_thread.join();
+            }
+        }
+    };
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include "engine/Game.hpp"
+#include "engine/Piece.hpp"
+#include "engine/Placement.hpp"
+#include "VersusGame.hpp"
+
+#include "Eval.hpp"
+
+namespace Shaktris {
+    namespace Search {
+
+        using clock = std::chrono::steady_clock;
+
+        using Evaluator = float (*)(const Game&);
+
+        inline float default_evaluator(const Game& game) {
+            return evaluate(game.board);
+        }
+
+        struct SearchLimits {
+            // beam width of the first iteration, doubled every iteration after that
+            std::size_t initial_width = 4;
+            std::size_t max_width = 4096;
+            // score per line of garbage sent on the way to a node
+            float attack_weight = 2.0f;
+        };
+
+        struct SearchResult {
+            std::optional<Piece> best;
+            float score = 0;
+            std::size_t width = 0;  // beam width of the deepest finished iteration
+            int depth = 0;
+            u64 nodes = 0;
+        };
+
+        // beam search that keeps widening until it runs out of time
+        // every finished iteration replaces the answer, an unfinished one is thrown away,
+        // so the result is always the best move of the widest beam that completed in time
+        class AnytimeSearch {
+        public:
+            explicit AnytimeSearch(SearchLimits limits = {}, Evaluator evaluator = default_evaluator)
+                : limits(limits), evaluator(evaluator) {}
+
+            ~AnytimeSearch() {
+                stop_pondering();
+            }
+
+            AnytimeSearch(const AnytimeSearch&) = delete;
+            AnytimeSearch& operator=(const AnytimeSearch&) = delete;
+
+            // searches until the deadline, the stop token fires or the beam is as wide as allowed
+            SearchResult search(const Game& root, clock::time_point deadline, std::stop_token stop = {});
+
+            // starts thinking in the background about what to play if the opponent's move leads to this state
+            void ponder(const VersusGame& predicted, int id);
+
+            // the real state is known, if it matches the prediction the pondering search keeps going
+            // until the deadline and its results are reused, otherwise a fresh search is started
+            SearchResult ponder_hit(const VersusGame& actual, int id, clock::time_point deadline);
+
+            void stop_pondering();
+
+        private:
+            struct Node {
+                Game game;
+                float score;
+                float attack;
+                u16 root_move;
+            };
+
+            SearchResult run(const Game& root, std::stop_token stop, bool publish);
+            void expand(const Node& node, const Piece& move, u16 root_move);
+            void prune(std::vector<Node>& nodes, std::size_t width) const;
+            bool out_of_time(const std::stop_token& stop) const;
+
+            SearchLimits limits;
+            Evaluator evaluator;
+
+            std::atomic<clock::rep> deadline_ticks = 0;
+
+            std::jthread ponder_thread;
+            // the position being pondered, compared in full since a hash match could be another position
+            Game ponder_game;
+            std::mutex result_lock;
+            SearchResult ponder_result;
+
+            // children expanded between two looks at the clock
+            static constexpr std::size_t deadline_check_interval = 16;
+
+            // reused between iterations and searches, movegen fills these in place
+            // so once a search has been as wide as the next one it does not allocate
+            std::vector<Node> first_layer;
+            std::vector<Node> layer;
+            std::vector<Node> next_layer;
+            std::vector<Placement> root_moves;
+            std::vector<Placement> moves;
+        };
+    };
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <span>
+
+#include "engine/BatchPlace.hpp"
+#include "engine/Board.hpp"
+#include "engine/Game.hpp"
+
+namespace Shaktris {
+    namespace Search {
+
+        // weights for the default board heuristic, higher score is better
+        struct EvalWeights {
+            float height = -0.5f;
+            float holes = -4.0f;
+            float bumpiness = -0.35f;
+            float danger = -8.0f;  // per row above the danger line
+        };
+
+        constexpr int danger_height = 14;
+
+        // cheap hand tuned heuristic, good enough to drive the search without a trained model
+        constexpr float evaluate(const Board& board, const EvalWeights& weights = {}) {
+            int aggregate_height = 0;
+            int holes = 0;
+            int bumpiness = 0;
+            int max_height = 0;
+            int last_height = -1;
+
+            for (size_t x = 0; x < Board::width; ++x) {
+                const column_t col = board.board[x];
+                const int height = std::bit_width(col);
+
+                aggregate_height += height;
+                holes += height - std::popcount(col);
+                max_height = std::max(max_height, height);
+
+                if (last_height >= 0)
+                    bumpiness += std::abs(height - last_height);
+                last_height = height;
+            }
+
+            return weights.height * aggregate_height +
+                weights.holes * holes +
+                weights.bumpiness * bumpiness +
+                weights.danger * std::max(0, max_height - danger_height);
+        }
+
+        // same heuristic over every child of a batch, column by column so each step runs across children
+        inline void evaluate(const Batch::ChildBoards& children, std::span<float> scores, const EvalWeights& weights = {}) {
+            const std::size_t n = children.count;
+
+            thread_local std::vector<int> last_height;
+            thread_local std::vector<int> max_height;
+            last_height.resize(n);
+            max_height.resize(n);
+
+            for (std::size_t i = 0; i < n; ++i) {
+                scores[i] = 0;
+                max_height[i] = 0;
+            }
+
+            for (std::size_t x = 0; x < Board::width; ++x) {
+                const column_t* col = children.columns[x].data();
+                for (std::size_t i = 0; i < n; ++i) {
+                    const int height = std::bit_width(col[i]);
+                    const int holes = height - std::popcount(col[i]);
+
+                    float score = weights.height * height + weights.holes * holes;
+                    if (x > 0)
+                        score += weights.bumpiness * std::abs(height - last_height[i]);
+
+                    scores[i] += score;
+                    last_height[i] = height;
+                    max_height[i] = std::max(max_height[i], height);
+                }
+            }
+
+            for (std::size_t i = 0; i < n; ++i)
+                scores[i] += weights.danger * std::max(0, max_height[i] - danger_height);
+        }
+    };
+};
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <optional>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#include <xmmintrin.h>
+#endif
+
+#include "engine/ShaktrisConstants.hpp"
+
+namespace Shaktris {
+    namespace Search {
+
+        enum class Bound : u8 {
+            None,
+            Exact,
+            Lower,  // score is at least this much
+            Upper,  // score is at most this much
+        };
+
+        // everything a search wants to remember about a position, packed into 64 bits
+        // so that it can be written with a single atomic store
+        // the top bit is always set in a stored entry, so an empty slot (all zero) never looks like a real one
+        struct TTData {
+            static constexpr u64 valid = u64(1) << 63;
+            static constexpr u8 generation_mask = 0x1f;
+
+            i32 score = 0;
+            u16 move = 0;  // opaque to the table, usually a packed placement
+            u8 depth = 0;
+            Bound bound = Bound::None;
+
+            constexpr u64 pack(u8 generation) const {
+                return u64(u32(score)) |
+                    (u64(move) << 32) |
+                    (u64(depth) << 48) |
+                    (u64(static_cast<u8>(bound)) << 56) |
+                    (u64(generation & generation_mask) << 58) |
+                    valid;
+            }
+
+            static constexpr TTData unpack(u64 bits) {
+                TTData ret;
+                ret.score = i32(u32(bits));
+                ret.move = u16(bits >> 32);
+                ret.depth = u8(bits >> 48);
+                ret.bound = static_cast<Bound>((bits >> 56) & 0x3);
+                return ret;
+            }
+
+            static constexpr u8 generation_of(u64 bits) {
+                return u8(bits >> 58) & generation_mask;
+            }
+        };
+
+        // compile time unit tests for sanity
+        consteval bool tt_pack_test() {
+            // the emptiest entry there is still packs to something a zeroed slot is not
+            const u64 bits = TTData{}.pack(0);
+            const TTData back = TTData::unpack(bits);
+            return bits != 0 && back.score == 0 && back.move == 0 && back.depth == 0 && back.bound == Bound::None &&
+                TTData::generation_of(TTData{ -5, 7, 3, Bound::Upper }.pack(31)) == 31;
+        }
+
+        static_assert(tt_pack_test(), "tt packing didnt work");
+
+        // replacement policies, the slot with the lowest priority in a bucket gets evicted
+        namespace Replacement {
+            // newest entry always wins, evicts slots in order
+            struct Always {
+                static constexpr int priority(u64 /*data*/, u8 /*generation*/) {
+                    return 0;
+                }
+            };
+
+            // keep the deepest searches around regardless of age
+            struct DepthPreferred {
+                static constexpr int priority(u64 data, u8 /*generation*/) {
+                    return TTData::unpack(data).depth;
+                }
+            };
+
+            // deep entries are preferred, but entries from older searches lose value quickly
+            struct Aging {
+                static constexpr int priority(u64 data, u8 generation) {
+                    const int age = (generation - TTData::generation_of(data)) & TTData::generation_mask;
+                    return int(TTData::unpack(data).depth) - 8 * age;
+                }
+            };
+        };
+
+        // allocation helpers, the table asks for 2MB pages where the os lets us
+        constexpr std::size_t huge_page_size = 2 * 1024 * 1024;
+
+        inline void* large_page_alloc(std::size_t bytes) {
+            bytes = (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+#if defined(_MSC_VER)
+            return _aligned_malloc(bytes, huge_page_size);
+#else
+            void* mem = std::aligned_alloc(huge_page_size, bytes);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            if (mem)
+                madvise(mem, bytes, MADV_HUGEPAGE);
+#endif
+            return mem;
+#endif
+        }
+
+        inline void large_page_free(void* mem) {
+#if defined(_MSC_VER)
+            _aligned_free(mem);
+#else
+            std::free(mem);
+#endif
+        }
+
+        inline void prefetch(const void* addr) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(addr);
+#elif defined(_M_X64) || defined(_M_IX86)
+            _mm_prefetch(static_cast<const char*>(addr), _MM_HINT_T0);
+#endif
+        }
+
+        // lockless shared hash table, safe to probe and store from any number of threads.
+        // each slot stores key ^ data next to data, so a torn write from two racing threads
+        // fails the key check on probe instead of returning garbage (hyatt's xor trick)
+        template <class Policy = Replacement::Aging>
+        class TranspositionTable {
+        public:
+            struct Entry {
+                std::atomic<u64> key_xor_data;
+                std::atomic<u64> data;
+            };
+
+            static constexpr std::size_t bucket_size = 4;
+
+            struct alignas(64) Bucket {
+                std::array<Entry, bucket_size> entries;
+            };
+            static_assert(sizeof(Bucket) == 64, "a bucket should fill exactly one cache line");
+
+            explicit TranspositionTable(std::size_t megabytes) {
+                resize(megabytes);
+            }
+
+            TranspositionTable(const TranspositionTable&) = delete;
+            TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+            ~TranspositionTable() {
+                large_page_free(buckets);
+            }
+
+            // not thread safe, call between searches
+            void resize(std::size_t megabytes) {
+                large_page_free(buckets);
+                buckets = nullptr;
+
+                const std::size_t wanted = std::max<std::size_t>(1, megabytes * 1024 * 1024 / sizeof(Bucket));
+                bucket_count = std::bit_floor(wanted);
+
+                buckets = static_cast<Bucket*>(large_page_alloc(bucket_count * sizeof(Bucket)));
+                if (!buckets)
+                    throw std::bad_alloc();
+
+                clear();
+            }
+
+            // not thread safe, call between searches
+            void clear() {
+                for (std::size_t i = 0; i < bucket_count; ++i) {
+                    new (&buckets[i]) Bucket{};
+                }
+                generation = 0;
+            }
+
+            // call once at the start of every search so old entries age out
+            void new_search() {
+                generation = (generation + 1) & TTData::generation_mask;
+            }
+
+            void prefetch(u64 key) const {
+                Search::prefetch(&bucket_for(key));
+            }
+
+            std::optional<TTData> probe(u64 key) const {
+                const Bucket& bucket = bucket_for(key);
+                for (const Entry& entry : bucket.entries) {
+                    const u64 data = entry.data.load(std::memory_order_relaxed);
+                    const u64 check = entry.key_xor_data.load(std::memory_order_relaxed);
+                    if ((check ^ data) == key && data != 0)
+                        return TTData::unpack(data);
+                }
+                return std::nullopt;
+            }
+
+            void store(u64 key, const TTData& value) {
+                Bucket& bucket = bucket_for(key);
+
+                Entry* victim = &bucket.entries[0];
+                int victim_priority = std::numeric_limits<int>::max();
+
+                for (Entry& entry : bucket.entries) {
+                    const u64 data = entry.data.load(std::memory_order_relaxed);
+                    const u64 check = entry.key_xor_data.load(std::memory_order_relaxed);
+
+                    // same position, always overwrite
+                    if ((check ^ data) == key || data == 0) {
+                        victim = &entry;
+                        break;
+                    }
+
+                    const int priority = Policy::priority(data, generation);
+                    if (priority < victim_priority) {
+                        victim_priority = priority;
+                        victim = &entry;
+                    }
+                }
+
+                const u64 data = value.pack(generation);
+                victim->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+                victim->data.store(data, std::memory_order_relaxed);
+            }
+
+            // permille of sampled slots written during the current search
+            int hashfull() const {
+                const std::size_t samples = std::min<std::size_t>(bucket_count, 1000 / bucket_size);
+                int used = 0;
+                for (std::size_t i = 0; i < samples; ++i) {
+                    for (const Entry& entry : buckets[i].entries) {
+                        const u64 data = entry.data.load(std::memory_order_relaxed);
+                        used += data != 0 && TTData::generation_of(data) == generation;
+                    }
+                }
+                return int(used * 1000 / (samples * bucket_size));
+            }
+
+            std::size_t size() const {
+                return bucket_count * bucket_size;
+            }
+
+        private:
+            Bucket& bucket_for(u64 key) const {
+                return buckets[key & (bucket_count - 1)];
+            }
+
+            Bucket* buckets = nullptr;
+            std::size_t bucket_count = 0;
+            u8 generation = 0;
+        };
+    };
+};
@@ -0,0 +1,559 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "engine/Board.hpp"
+#include "engine/Game.hpp"
+#include "engine/Piece.hpp"
+#include "engine/ShaktrisConstants.hpp"
+#include "search/AnytimeSearch.hpp"
+
+// Tetris Bot Protocol frontend
+// https://github.com/tetris-bot-protocol/tbp-spec
+// messages are parsed in place straight into the Game, there is no json document in between
+namespace Shaktris {
+    namespace TBP {
+
+        // forward only cursor over a single json message
+        // only understands as much json as tbp needs, anything unexpected makes it give up on the message
+        class JsonCursor {
+        public:
+            explicit JsonCursor(std::string_view text) : pos(text.data()), end(text.data() + text.size()) {}
+
+            bool ok() const {
+                return !failed;
+            }
+
+            // for values that are valid json but not a valid tbp value
+            void fail() {
+                failed = true;
+            }
+
+            // nothing but whitespace left after the message
+            bool at_end() {
+                skip_ws();
+                return pos == end;
+            }
+
+            void skip_ws() {
+                while (pos < end && (*pos == ' ' || *pos == '\t' || *pos == '\n' || *pos == '\r'))
+                    ++pos;
+            }
+
+            char peek() {
+                skip_ws();
+                return pos < end ? *pos : '\0';
+            }
+
+            bool consume(char c) {
+                if (peek() == c) {
+                    ++pos;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char c) {
+                if (!consume(c))
+                    failed = true;
+            }
+
+            // tbp never needs escapes in the strings we care about, escaped characters are skipped over
+            std::string_view string() {
+                if (!consume('"')) {
+                    failed = true;
+                    return {};
+                }
+                const char* start = pos;
+                while (pos < end && *pos != '"') {
+                    if (*pos == '\\')
+                        ++pos;
+                    ++pos;
+                }
+                std::string_view ret(start, static_cast<size_t>(std::min(pos, end) - start));
+                if (pos < end)
+                    ++pos;
+                else
+                    failed = true;
+                return ret;
+            }
+
+            int integer() {
+                skip_ws();
+                int value = 0;
+                auto [ptr, ec] = std::from_chars(pos, end, value);
+                if (ec != std::errc())
+                    failed = true;
+                pos = ptr;
+                return value;
+            }
+
+            bool null() {
+                skip_ws();
+                if (end - pos >= 4 && std::string_view(pos, 4) == "null") {
+                    pos += 4;
+                    return true;
+                }
+                return false;
+            }
+
+            bool boolean() {
+                skip_ws();
+                if (end - pos >= 4 && std::string_view(pos, 4) == "true") {
+                    pos += 4;
+                    return true;
+                }
+                if (end - pos >= 5 && std::string_view(pos, 5) == "false") {
+                    pos += 5;
+                    return false;
+                }
+                failed = true;
+                return false;
+            }
+
+            // skips any value, including nested objects and arrays
+            void skip() {
+                switch (peek()) {
+                case '"':
+                    string();
+                    break;
+                case '{':
+                case '[': {
+                    int depth = 0;
+                    do {
+                        const char c = *pos;
+                        if (c == '"') {
+                            string();
+                            continue;
+                        }
+                        if (c == '{' || c == '[')
+                            depth++;
+                        else if (c == '}' || c == ']')
+                            depth--;
+                        ++pos;
+                    } while (depth > 0 && pos < end);
+                    break;
+                }
+                default:
+                    while (pos < end && *pos != ',' && *pos != '}' && *pos != ']')
+                        ++pos;
+                    break;
+                }
+            }
+
+            // calls f(key) for every member of an object, f has to consume the value
+            template <class F>
+            void object(F&& f) {
+                expect('{');
+                if (consume('}'))
+                    return;
+                while (ok()) {
+                    const std::string_view key = string();
+                    expect(':');
+                    if (!ok())
+                        return;
+                    f(key);
+                    if (consume(','))
+                        continue;
+                    expect('}');
+                    return;
+                }
+            }
+
+            // calls f(index) for every element of an array, f has to consume the element
+            template <class F>
+            void array(F&& f) {
+                expect('[');
+                if (consume(']'))
+                    return;
+                for (size_t i = 0; ok(); ++i) {
+                    f(i);
+                    if (consume(','))
+                        continue;
+                    expect(']');
+                    return;
+                }
+            }
+
+        private:
+            const char* pos;
+            const char* end;
+            bool failed = false;
+        };
+
+        constexpr std::array<std::string_view, 7> piece_names = { "S", "Z", "J", "L", "T", "O", "I" };
+        constexpr std::array<std::string_view, 4> orientation_names = { "north", "east", "south", "west" };
+        constexpr std::array<std::string_view, 3> spin_names = { "none", "mini", "full" };
+
+        inline std::optional<PieceType> parse_piece(std::string_view name) {
+            for (size_t i = 0; i < piece_names.size(); ++i) {
+                if (piece_names[i] == name)
+                    return static_cast<PieceType>(i);
+            }
+            return std::nullopt;
+        }
+
+        inline std::optional<RotationDirection> parse_orientation(std::string_view name) {
+            for (size_t i = 0; i < orientation_names.size(); ++i) {
+                if (orientation_names[i] == name)
+                    return static_cast<RotationDirection>(i);
+            }
+            return std::nullopt;
+        }
+
+        inline std::optional<spinType> parse_spin(std::string_view name) {
+            for (size_t i = 0; i < spin_names.size(); ++i) {
+                if (spin_names[i] == name)
+                    return static_cast<spinType>(i);
+            }
+            return std::nullopt;
+        }
+
+        // a name that is not one of ours fails the whole message instead of turning into some default
+        template <class T>
+        T require(JsonCursor& json, std::optional<T> value) {
+            if (!value)
+                json.fail();
+            return value.value_or(T{});
+        }
+
+        // tbp locations use the same rotation centers as rot_piece_def, so pieces map over one to one
+        // every field has to be there and in range, otherwise there is no move
+        inline std::optional<Piece> parse_move(JsonCursor& json) {
+            PieceType type = PieceType::Empty;
+            RotationDirection rotation = RotationDirection::North;
+            int x = -1;
+            int y = -1;
+            std::optional<spinType> spin;
+            bool has_type = false;
+            bool has_orientation = false;
+
+            json.object([&](std::string_view key) {
+                if (key == "location") {
+                    json.object([&](std::string_view field) {
+                        if (field == "type") {
+                            type = require(json, parse_piece(json.string()));
+                            has_type = true;
+                        }
+                        else if (field == "orientation") {
+                            rotation = require(json, parse_orientation(json.string()));
+                            has_orientation = true;
+                        }
+                        else if (field == "x")
+                            x = json.integer();
+                        else if (field == "y")
+                            y = json.integer();
+                        else
+                            json.skip();
+                    });
+                }
+                else if (key == "spin")
+                    spin = require(json, parse_spin(json.string()));
+                else
+                    json.skip();
+            });
+
+            if (!json.ok() || !has_type || !has_orientation || !spin ||
+                x < 0 || x >= (int)Board::width || y < 0 || y >= (int)Board::height) {
+                json.fail();
+                return std::nullopt;
+            }
+            return Piece(type, rotation, Coord((i8)x, (i8)y), *spin);
+        }
+
+        // appends to a reused string, the capacity sticks around so steady state output never allocates
+        class Writer {
+        public:
+            explicit Writer(std::string& out) : out(out) {}
+
+            Writer& raw(std::string_view text) {
+                out.append(text);
+                return *this;
+            }
+
+            Writer& str(std::string_view text) {
+                out.push_back('"');
+                out.append(text);
+                out.push_back('"');
+                return *this;
+            }
+
+            Writer& integer(int value) {
+                std::array<char, 16> buffer;
+                auto [ptr, ec] = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+                out.append(buffer.data(), ptr);
+                return *this;
+            }
+
+            Writer& move(const Piece& piece) {
+                raw("{\"location\":{\"type\":").str(piece_names[static_cast<size_t>(piece.type)]);
+                raw(",\"orientation\":").str(orientation_names[piece.rotation]);
+                raw(",\"x\":").integer(piece.position.x);
+                raw(",\"y\":").integer(piece.position.y);
+                raw("},\"spin\":").str(spin_names[static_cast<size_t>(piece.spin)]);
+                return raw("}");
+            }
+
+        private:
+            std::string& out;
+        };
+
+        class Bot {
+        public:
+            static constexpr size_t max_queue = 64;
+
+            explicit Bot(std::chrono::microseconds think_time = std::chrono::milliseconds(20))
+                : think_time(think_time) {}
+
+            // the first thing a bot sends
+            void info(std::string& out) const {
+                out.clear();
+                Writer(out).raw("{\"type\":\"info\",\"name\":\"ShakTris\",\"version\":\"0.1\",\"author\":\"Shakkar23\",\"features\":[]}\n");
+            }
+
+            // handles one message, writes the reply (if there is one) to out
+            // a malformed message is dropped without touching the state and counted in rejected()
+            // returns false once the frontend asked us to quit
+            bool handle(std::string_view message, std::string& out) {
+                out.clear();
+
+                // "type" is not guaranteed to be the first key, so find it before looking at the rest
+                std::string_view type;
+                {
+                    JsonCursor json(message);
+                    json.object([&](std::string_view key) {
+                        if (key == "type")
+                            type = json.string();
+                        else
+                            json.skip();
+                    });
+                    if (!json.ok() || !json.at_end() || type.empty()) {
+                        rejected_messages++;
+                        return true;
+                    }
+                }
+
+                JsonCursor json(message);
+                bool accepted = true;
+                if (type == "rules") {
+                    Writer(out).raw("{\"type\":\"ready\"}\n");
+                }
+                else if (type == "start") {
+                    accepted = start(json);
+                }
+                else if (type == "stop") {
+                    running = false;
+                }
+                else if (type == "suggest") {
+                    if (running)
+                        suggest(out);
+                }
+                else if (type == "play") {
+                    if (running)
+                        accepted = play(json);
+                }
+                else if (type == "new_piece") {
+                    accepted = new_piece(json);
+                }
+                else if (type == "quit") {
+                    return false;
+                }
+                // anything else is a message from a newer version of the spec, which tbp says to ignore
+
+                if (!accepted)
+                    rejected_messages++;
+                return true;
+            }
+
+            const Game& game_state() const {
+                return game;
+            }
+
+            bool is_running() const {
+                return running;
+            }
+
+            // how many messages were dropped for being malformed
+            size_t rejected() const {
+                return rejected_messages;
+            }
+
+        private:
+            // the new state is only kept if the whole message parsed
+            bool start(JsonCursor& json) {
+                const Game previous = game;
+                const auto previous_queue = queue;
+                const size_t previous_head = queue_head;
+                const size_t previous_size = queue_size;
+
+                game = Game();
+                queue_size = 0;
+                queue_head = 0;
+
+                json.object([&](std::string_view key) {
+                    if (key == "hold") {
+                        if (json.null())
+                            game.hold.reset();
+                        else
+                            game.hold = require(json, parse_piece(json.string()));
+                    }
+                    else if (key == "queue") {
+                        json.array([&](size_t) { push_piece(require(json, parse_piece(json.string()))); });
+                    }
+                    else if (key == "combo") {
+                        game.combo = (u16)json.integer();
+                    }
+                    else if (key == "back_to_back") {
+                        game.b2b = json.boolean();
+                    }
+                    else if (key == "board") {
+                        // rows bottom to top, each row is 10 cells of null or a color string
+                        json.array([&](size_t y) {
+                            json.array([&](size_t x) {
+                                if (x >= Board::width)
+                                    json.fail();
+                                if (json.null())
+                                    return;
+                                json.string();
+                                // tbp boards are 40 rows, a filled cell above ours can not be represented
+                                if (y >= Board::height)
+                                    json.fail();
+                                else if (x < Board::width)
+                                    game.board.set(x, y);
+                            });
+                        });
+                    }
+                    else {
+                        json.skip();
+                    }
+                });
+
+                if (!json.ok()) {
+                    game = previous;
+                    queue = previous_queue;
+                    queue_head = previous_head;
+                    queue_size = previous_size;
+                    return false;
+                }
+
+                running = true;
+                sync_queue();
+                return true;
+            }
+
+            void suggest(std::string& out) {
+                Writer writer(out);
+                writer.raw("{\"type\":\"suggestion\",\"moves\":[");
+
+                if (game.current_piece.type != PieceType::Empty) {
+                    const auto result = search.search(game, Search::clock::now() + think_time);
+                    bool first = true;
+                    if (result.best) {
+                        writer.move(*result.best);
+                        first = false;
+                    }
+
+                    // every other legal placement as a fallback, in movegen order
+                    for (const Piece& piece : game.get_possible_piece_placements()) {
+                        if (result.best && piece.type == result.best->type && piece.rotation == result.best->rotation &&
+                            piece.position.x == result.best->position.x && piece.position.y == result.best->position.y)
+                            continue;
+                        if (!first)
+                            writer.raw(",");
+                        writer.move(piece);
+                        first = false;
+                    }
+                }
+
+                writer.raw("]}\n");
+            }
+
+            bool play(JsonCursor& json) {
+                std::optional<Piece> move;
+                json.object([&](std::string_view key) {
+                    if (key == "move")
+                        move = parse_move(json);
+                    else
+                        json.skip();
+                });
+                if (!json.ok() || !move)
+                    return false;
+
+                // playing something other than the current piece means it came out of hold,
+                // and with an empty hold that also eats the next piece of the queue
+                const bool used_hold = move->type != game.current_piece.type;
+                const bool first_hold = used_hold && !game.hold.has_value();
+
+                game.place_piece(*move);
+                pop_piece();
+                if (first_hold)
+                    pop_piece();
+
+                const int lines_cleared = game.board.clearLines();
+                game.damage_sent(lines_cleared, move->spin, game.board.is_empty());
+
+                sync_queue();
+                return true;
+            }
+
+            bool new_piece(JsonCursor& json) {
+                std::optional<PieceType> type;
+                json.object([&](std::string_view key) {
+                    if (key == "piece")
+                        type = require(json, parse_piece(json.string()));
+                    else
+                        json.skip();
+                });
+                if (!json.ok() || !type)
+                    return false;
+
+                push_piece(*type);
+                sync_queue();
+                return true;
+            }
+
+            void push_piece(PieceType type) {
+                if (type == PieceType::Empty || queue_size == max_queue)
+                    return;
+                queue[(queue_head + queue_size) % max_queue] = type;
+                queue_size++;
+            }
+
+            void pop_piece() {
+                if (queue_size == 0)
+                    return;
+                queue_head = (queue_head + 1) % max_queue;
+                queue_size--;
+            }
+
+            PieceType queue_at(size_t i) const {
+                return i < queue_size ? queue[(queue_head + i) % max_queue] : PieceType::Empty;
+            }
+
+            // the frontend's queue is the source of truth, the game only sees as much of it as it can hold
+            void sync_queue() {
+                game.current_piece = Piece(queue_at(0));
+                for (size_t i = 0; i < game.queue.size(); ++i)
+                    game.queue.set(i, queue_at(i + 1));
+            }
+
+            Game game;
+            Search::AnytimeSearch search;
+            std::chrono::microseconds think_time;
+
+            std::array<PieceType, max_queue> queue{};
+            size_t queue_head = 0;
+            size_t queue_size = 0;
+
+            bool running = false;
+            size_t rejected_messages = 0;
+        };
+    };
+};
@@ -0,0 +1,47 @@
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "Tbp.hpp"
+
+// speaks the tetris bot protocol over stdin/stdout, one json message per line
+// usage: ShakTrisTBP [--think-ms N]
+int main(int argc, char** argv) {
+    int think_ms = 20;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string_view(argv[i]) == "--think-ms") {
+            const std::string_view value = argv[i + 1];
+            std::from_chars(value.data(), value.data() + value.size(), think_ms);
+        }
+    }
+
+    std::ios::sync_with_stdio(false);
+
+    Shaktris::TBP::Bot bot{ std::chrono::milliseconds(think_ms) };
+
+    std::string line;
+    std::string reply;
+    line.reserve(4096);
+    reply.reserve(16384);
+
+    bot.info(reply);
+    std::fwrite(reply.data(), 1, reply.size(), stdout);
+    std::fflush(stdout);
+
+    while (std::getline(std::cin, line)) {
+        const bool keep_going = bot.handle(line, reply);
+
+        if (!reply.empty()) {
+            std::fwrite(reply.data(), 1, reply.size(), stdout);
+            std::fflush(stdout);
+        }
+
+        if (!keep_going)
+            break;
+    }
+
+    return 0;
+}
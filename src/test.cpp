@@ -1,11 +1,45 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <iomanip>  // for std::setw and std::setfill
 #include <iostream>
+#include <limits>
+#include <new>
 #include <numeric>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
+#include "BatchSimulator.hpp"
+#include "datagen/DataGen.hpp"
+#include "engine/ActionMask.hpp"
+#include "engine/BatchPlace.hpp"
 #include "engine/Board.hpp"
+#include "engine/Game.hpp"
+#include "engine/GameState.hpp"
 #include "engine/MoveGen.hpp"
+#include "engine/MoveSampling.hpp"
+#include "engine/PathSearch.hpp"
+#include "engine/Placement.hpp"
+#include "engine/Reachability.hpp"
+#include "VecEnv.hpp"
+#include "VersusGame.hpp"
+#include "replay/Replay.hpp"
+#include "replay/ReplayCheck.hpp"
+#include "search/AnytimeSearch.hpp"
+#include "search/Eval.hpp"
+#include "search/TranspositionTable.hpp"
+#include "tbp/Tbp.hpp"
+#include "util/hash.hpp"
+#include "util/randomizer.hpp"
+#include "util/rng.hpp"
+#include "util/threadpool.hpp"
 
 char rot_to_char(RotationDirection rot) {
     switch (rot) {
@@ -53,6 +87,78 @@ void print_board(const Board& board) {
     }
 }
 
+// counts every heap allocation the benches make, for checking hot paths stay off the heap
+static std::atomic<std::size_t> allocations = 0;
+
+// every form of new goes through these two and every form of delete through release, so malloc and free always pair up
+static void* counted_alloc(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+static void* counted_alloc(std::size_t size, std::align_val_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a multiple of the alignment
+    if (void* ptr = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+static void release(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size) {
+    return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size) {
+    return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return counted_alloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return counted_alloc(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    release(ptr);
+}
+
 using Nodes = int64_t;
 
 template <std::size_t N>
@@ -268,7 +374,2128 @@ void kise() {
         << std::setw(1) << milliseconds.count() << "ms" << std::endl;
 }
 
-int main() {
+// shared transposition table throughput under contention
+void tt_bench() {
+    using namespace Shaktris::Search;
+
+    TranspositionTable<> tt(256);
+    constexpr size_t ops_per_thread = 4'000'000;
+
+    // an all zero entry from the first search is still an entry
+    tt.store(1234, TTData{});
+    const std::optional<TTData> zero = tt.probe(1234);
+    std::cout << "zero entry kept: " << (zero && zero->score == 0 && zero->bound == Bound::None ? "yes" : "NO") << std::endl;
+
+    for (size_t threads = 1; threads <= 64; threads *= 2) {
+        tt.clear();
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        std::atomic<u64> hits = 0;
+
+        auto time_start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&tt, &hits, t] {
+                u64 state = 0x9e3779b97f4a7c15ULL * (t + 1);
+                u64 local_hits = 0;
+                for (size_t i = 0; i < ops_per_thread; ++i) {
+                    // xorshift, keys are shared between threads on purpose so they fight over buckets
+                    state ^= state << 13;
+                    state ^= state >> 7;
+                    state ^= state << 17;
+                    const u64 key = hash_mix(state & 0xfffff);
+
+                    tt.prefetch(key);
+                    if (tt.probe(key))
+                        local_hits++;
+                    else
+                        tt.store(key, TTData{ (i32)i, (u16)i, (u8)(i & 31), Bound::Exact });
+                }
+                hits += local_hits;
+            });
+        }
+        for (auto& worker : workers)
+            worker.join();
+        auto time_stop = std::chrono::steady_clock::now();
+
+        const double seconds = std::chrono::duration<double>(time_stop - time_start).count();
+        std::cout << "threads: " << threads
+            << "\tMops/s: " << (threads * ops_per_thread) / seconds / 1e6
+            << "\thit rate: " << double(hits) / (threads * ops_per_thread)
+            << "\thashfull: " << tt.hashfull() << std::endl;
+    }
+}
+
+// same as perft, but levels with enough depth left fork their children onto the pool
+template <std::size_t N>
+static Nodes parallel_perft(ThreadPool& pool, Board board, const Piece& move, const std::array<PieceType, N>& queue, int i, int depth) {
+    using namespace Shaktris::MoveGen::Smeared;
+
+    if (depth <= 3)
+        return perft(board, move, queue, i, depth);
+
+    board.set(move);
+    board.clearLines();
+
+    auto moves = god_movegen(board, queue[i]);
+    std::vector<Nodes> counts(moves.size());
+    parallel_for(pool, 0, moves.size(), 1, [&](size_t m) {
+        counts[m] = parallel_perft(pool, board, moves[m], queue, i + 1, depth - 1);
+    });
+
+    return std::accumulate(counts.begin(), counts.end(), Nodes(0));
+}
+
+template <std::size_t N>
+static Nodes parallel_perft(ThreadPool& pool, Board& board, const std::array<PieceType, N>& queue, int depth) {
+    using namespace Shaktris::MoveGen::Smeared;
+
+    if (depth <= 3)
+        return perft(board, queue, depth);
+
+    auto moves = god_movegen(board, queue[0]);
+    std::vector<Nodes> counts(moves.size());
+    parallel_for(pool, 0, moves.size(), 1, [&](size_t m) {
+        counts[m] = parallel_perft(pool, board, moves[m], queue, 1, depth - 1);
+    });
+
+    return std::accumulate(counts.begin(), counts.end(), Nodes(0));
+}
+
+// task overhead of the pool against std::async, plus a parallel perft
+void pool_bench() {
+    ThreadPool pool;
+
+    constexpr size_t tasks = 100'000;
+    std::atomic<size_t> sum = 0;
+    auto tiny = [&] { sum.fetch_add(1, std::memory_order_relaxed); };
+
+    {
+        auto time_start = std::chrono::steady_clock::now();
+        TaskGroup group(pool);
+        for (size_t i = 0; i < tasks; ++i)
+            group.run(tiny);
+        group.wait();
+        auto time_stop = std::chrono::steady_clock::now();
+        std::cout << "pool:       " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_start).count() / tasks << " ns/task" << std::endl;
+    }
+
+    {
+        // a throwing task comes back out of wait() and the rest of the group still runs
+        std::atomic<size_t> ran = 0;
+        auto counted = [&] { ran.fetch_add(1, std::memory_order_relaxed); };
+        auto throwing = [] { throw std::runtime_error("task failed"); };
+        bool caught = false;
+        TaskGroup group(pool);
+        for (size_t i = 0; i < 64; ++i) {
+            if (i == 32)
+                group.run(throwing);
+            else
+                group.run(counted);
+        }
+        try {
+            group.wait();
+        }
+        catch (const std::runtime_error&) {
+            caught = true;
+        }
+        std::cout << "exception rethrown from wait: " << (caught && ran == 63 ? "yes" : "NO") << std::endl;
+    }
+
+    {
+        std::vector<std::future<void>> futures;
+        futures.reserve(tasks / 10);
+        auto time_start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < tasks / 10; ++i)
+            futures.emplace_back(std::async(std::launch::async, tiny));
+        for (auto& future : futures)
+            future.get();
+        auto time_stop = std::chrono::steady_clock::now();
+        std::cout << "std::async: " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_start).count() / (tasks / 10) << " ns/task" << std::endl;
+    }
+
+    std::array<PieceType, 7> queue{
+        PieceType::I,
+        PieceType::O,
+        PieceType::T,
+        PieceType::L,
+        PieceType::J,
+        PieceType::S,
+        PieceType::Z };
+
+    constexpr int depth = 5;
+    Board board;
+
+    auto time_start = std::chrono::steady_clock::now();
+    Nodes serial = perft(board, queue, depth);
+    auto time_mid = std::chrono::steady_clock::now();
+    Nodes parallel = parallel_perft(pool, board, queue, depth);
+    auto time_stop = std::chrono::steady_clock::now();
+
+    std::cout << "perft " << depth << " serial:   " << serial << " nodes in " << std::chrono::duration_cast<std::chrono::milliseconds>(time_mid - time_start).count() << "ms" << std::endl;
+    std::cout << "perft " << depth << " parallel: " << parallel << " nodes in " << std::chrono::duration_cast<std::chrono::milliseconds>(time_stop - time_mid).count() << "ms"
+        << " on " << pool.size() << " threads" << std::endl;
+}
+
+// how far past the deadline the anytime search returns, and how much pondering buys
+void search_bench() {
+    using namespace Shaktris::Search;
+
+    VersusGame game(12345);
+
+    AnytimeSearch search;
+    std::vector<int64_t> latencies;
+    constexpr int turns = 50;
+
+    for (int turn = 0; turn < turns; ++turn) {
+        const auto deadline = clock::now() + std::chrono::milliseconds(5);
+        SearchResult result = search.search(game.p1_game, deadline);
+        latencies.push_back(std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - deadline).count());
+
+        if (!result.best)
+            break;
+
+        game.set_move(0, Move(*result.best, false));
+        game.set_move(1, Move(*search.search(game.p2_game, clock::now() + std::chrono::milliseconds(1)).best, false));
+        game.play_moves();
+        if (game.game_over)
+            break;
+    }
+
+    // the same deadlines spent spinning on the clock, whatever this overshoots by is the scheduler and not the search
+    int64_t baseline = 0;
+    for (size_t i = 0; i < latencies.size(); ++i) {
+        const auto deadline = clock::now() + std::chrono::milliseconds(5);
+        while (clock::now() < deadline) {}
+        baseline = std::max<int64_t>(baseline, std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - deadline).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    const int64_t total_latency = std::accumulate(latencies.begin(), latencies.end(), int64_t(0));
+    const auto over = std::count_if(latencies.begin(), latencies.end(), [](int64_t latency) { return latency > 100; });
+    std::cout << "deadline latency: mean " << total_latency / (int64_t)latencies.size() << " us, median " << latencies[latencies.size() / 2]
+        << " us, worst " << latencies.back() << " us, " << over << "/" << latencies.size() << " over 100 us"
+        << "\tspinning on the clock alone: worst " << baseline << " us" << std::endl;
+
+    // ponder on the current state for a while, then ask for an answer with no time left
+    search.ponder(game, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    SearchResult pondered = search.ponder_hit(game, 0, clock::now());
+    SearchResult cold = search.search(game.p1_game, clock::now());
+    std::cout << "ponder hit width: " << pondered.width << " nodes: " << pondered.nodes
+        << "\tcold width: " << cold.width << " nodes: " << cold.nodes << std::endl;
+
+    // one counter off is another position, that has to search cold rather than take the pondered result
+    VersusGame changed = game;
+    changed.p1_game.combo++;
+    search.ponder(game, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    SearchResult missed = search.ponder_hit(changed, 0, clock::now());
+    std::cout << "changed position searches cold: " << (missed.nodes < pondered.nodes ? "yes" : "NO") << std::endl;
+}
+
+// per message overhead of the tbp frontend, everything except the search itself
+void tbp_bench() {
+    Shaktris::TBP::Bot bot;
+    std::string reply;
+    reply.reserve(16384);
+
+    std::string start = R"({"type":"start","hold":null,"queue":["T","I","O","L","J","S","Z"],"combo":0,"back_to_back":false,"board":[)";
+    for (int y = 0; y < 40; ++y) {
+        start += y ? ",[" : "[";
+        for (int x = 0; x < 10; ++x) {
+            start += x ? "," : "";
+            start += (y < 4 && x != y) ? "\"G\"" : "null";
+        }
+        start += "]";
+    }
+    start += "]}";
+
+    const std::string play = R"({"type":"play","move":{"location":{"type":"T","orientation":"north","x":4,"y":10},"spin":"none"}})";
+    const std::string new_piece = R"({"type":"new_piece","piece":"T"})";
+
+    // a scripted session, checking every reply on the way
+    {
+        Shaktris::TBP::Bot session{ std::chrono::milliseconds(2) };
+        bool ok = true;
+        auto check = [&](bool condition, const char* what) {
+            if (!condition) {
+                std::cout << "tbp session: " << what << " failed" << std::endl;
+                ok = false;
+            }
+        };
+
+        session.handle(R"({"type":"rules"})", reply);
+        check(reply == "{\"type\":\"ready\"}\n", "rules -> ready");
+
+        session.handle(start, reply);
+        check(reply.empty() && session.is_running() && session.game_state().current_piece.type == PieceType::T, "start");
+
+        session.handle(R"({"type":"suggest"})", reply);
+        check(reply.starts_with(R"({"type":"suggestion","moves":[{)") && reply.ends_with("]}\n"), "suggest -> suggestion");
+
+        // play back the first suggestion the way a frontend would
+        std::optional<Piece> suggested;
+        {
+            Shaktris::TBP::JsonCursor json(reply);
+            json.object([&](std::string_view key) {
+                if (key == "moves")
+                    json.array([&](size_t i) {
+                        if (i == 0)
+                            suggested = Shaktris::TBP::parse_move(json);
+                        else
+                            json.skip();
+                    });
+                else
+                    json.skip();
+            });
+            check(json.ok() && suggested.has_value() && suggested->type == PieceType::T, "suggestion parses back");
+        }
+        if (suggested) {
+            std::string play_suggested = R"({"type":"play","move":)";
+            Shaktris::TBP::Writer(play_suggested).move(*suggested).raw("}");
+            Board expected = session.game_state().board;
+            Piece placed = *suggested;
+            expected.set(placed);
+            expected.clearLines();
+
+            session.handle(play_suggested, reply);
+            check(reply.empty() && session.game_state().board == expected && session.game_state().current_piece.type == PieceType::I, "play");
+        }
+
+        session.handle(new_piece, reply);
+        check(reply.empty() && session.game_state().queue[5] == PieceType::T, "new_piece");
+
+        // malformed messages are dropped and leave the state alone
+        const u64 before = session.game_state().hash();
+        for (const std::string_view bad : {
+                 R"({"type":"new_piece","piece":"X"})",
+                 R"({"type":"new_piece"})",
+                 R"({"type":"play","move":{"location":{"type":"I","orientation":"up","x":4,"y":10},"spin":"none"}})",
+                 R"({"type":"play","move":{"location":{"type":"I","orientation":"north","x":4,"y":10},"spin":"tst"}})",
+                 R"({"type":"play","move":{"location":{"type":"I","orientation":"north","x":4},"spin":"none"}})",
+                 R"({"type":"play","move":{"location":{"type":"I","orientation":"north","x":40,"y":10},"spin":"none"}})",
+                 R"({"type":"start","hold":"Q","queue":["T"],"combo":0,"back_to_back":false,"board":[]})",
+                 R"({"type":"start","hold":null,"queue":["T","?"],"combo":0,"back_to_back":false,"board":[]})",
+                 R"({"type":"suggest"} trailing)",
+                 R"({"piece":"T"})" }) {
+            session.handle(bad, reply);
+        }
+        check(session.rejected() == 10 && session.game_state().hash() == before && session.is_running(), "malformed messages rejected");
+
+        session.handle(R"({"type":"stop"})", reply);
+        check(reply.empty() && !session.is_running(), "stop");
+        session.handle(R"({"type":"suggest"})", reply);
+        check(reply.empty(), "no suggestion after stop");
+
+        std::cout << "scripted session: " << (ok ? "ok" : "FAILED") << std::endl;
+    }
+
+    constexpr size_t count = 100'000;
+    auto time_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        bot.handle(start, reply);
+        bot.handle(play, reply);
+        bot.handle(new_piece, reply);
+    }
+    auto time_stop = std::chrono::steady_clock::now();
+
+    std::cout << "start + play + new_piece: " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_start).count() / count << " ns" << std::endl;
+}
+
+// batch place-and-clear kernel against a board copy, set and clearLines per child
+void batch_bench() {
+    Board board;
+    board.board[9] = 0b000011111111;
+    board.board[8] = 0b000011000000;
+    board.board[7] = 0b110011001100;
+    board.board[6] = 0b110011001100;
+    board.board[5] = 0b110011001100;
+    board.board[4] = 0b110011001100;
+    board.board[3] = 0b110011001100;
+    board.board[2] = 0b110000001100;
+    board.board[1] = 0b110000001100;
+    board.board[0] = 0b111111111100;
+
+    auto moves = Shaktris::MoveGen::Smeared::god_movegen(board, PieceType::I);
+    auto more = Shaktris::MoveGen::Smeared::god_movegen(board, PieceType::T);
+    moves.insert(moves.end(), more.begin(), more.end());
+
+    Shaktris::Batch::ChildBoards children;
+    std::vector<float> scores(moves.size());
+    constexpr size_t count = 100'000;
+
+    int64_t checksum = 0;
+    auto time_start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < count; ++n) {
+        for (const Piece& move : moves) {
+            Board child = board;
+            child.set(move);
+            checksum += child.clearLines();
+            checksum += (int64_t)Shaktris::Search::evaluate(child);
+        }
+    }
+    auto time_mid = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < count; ++n) {
+        Shaktris::Batch::place_and_clear(board, moves, children);
+        Shaktris::Search::evaluate(children, scores);
+        for (size_t i = 0; i < children.count; ++i)
+            checksum -= children.lines_cleared[i] + (int64_t)scores[i];
+    }
+    auto time_stop = std::chrono::steady_clock::now();
+
+    // make sure both paths agree
+    for (size_t i = 0; i < moves.size(); ++i) {
+        Board child = board;
+        child.set(moves[i]);
+        child.clearLines();
+        if (!(child == children.board(i)))
+            std::cout << "mismatch on child " << i << std::endl;
+    }
+
+    std::cout << "children: " << moves.size() << "\tchecksum: " << checksum << std::endl;
+    std::cout << "scalar: " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_mid - time_start).count() / count << " ns/node" << std::endl;
+    std::cout << "batch:  " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_mid).count() / count << " ns/node" << std::endl;
+}
+
+// movegen into Pieces against packed Placements, then copying and sorting the lists
+void placement_bench() {
+    Board board;
+    board.board[9] = 0b000011111111;
+    board.board[8] = 0b000011000000;
+    board.board[7] = 0b110011001100;
+    board.board[6] = 0b110011001100;
+    board.board[5] = 0b110011001100;
+    board.board[4] = 0b110011001100;
+    board.board[3] = 0b110011001100;
+    board.board[2] = 0b110000001100;
+    board.board[1] = 0b110000001100;
+    board.board[0] = 0b111111111100;
+
+    constexpr size_t count = 20'000;
+    std::vector<Piece> pieces;
+    std::vector<Placement> placements;
+    pieces.reserve(1024);
+    placements.reserve(1024);
+    for (size_t type = 0; type < (size_t)PieceType::Empty; ++type) {
+        auto moves = Shaktris::MoveGen::Smeared::god_movegen(board, (PieceType)type);
+        pieces.insert(pieces.end(), moves.begin(), moves.end());
+        Shaktris::MoveGen::Smeared::god_movegen(board, (PieceType)type, placements);
+    }
+
+    // the emit and storage path on its own, the same list of placements fed through the two sinks god_movegen has
+    // the best of a few rounds so one descheduling does not decide it
+    const std::vector<Placement> emitted = placements;
+    std::vector<Piece> piece_sink;
+    std::vector<Placement> placement_sink;
+    piece_sink.reserve(1024);
+    placement_sink.reserve(1024);
+    constexpr size_t emit_count = 200'000;
+    int64_t emit_ns[2] = { INT64_MAX, INT64_MAX };
+    int64_t sort_ns[2] = { INT64_MAX, INT64_MAX };
+    size_t checksum = 0;
+
+    for (int round = 0; round < 5; ++round) {
+        auto time_start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < emit_count; ++n) {
+            piece_sink.clear();
+            for (const Placement placement : emitted)
+                piece_sink.push_back(placement.to_piece());
+            checksum += piece_sink[n % piece_sink.size()].position.x;
+        }
+        auto time_mid = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < emit_count; ++n) {
+            placement_sink.clear();
+            for (const Placement placement : emitted)
+                placement_sink.push_back(placement);
+            checksum += placement_sink[n % placement_sink.size()].raw();
+        }
+        auto time_stop = std::chrono::steady_clock::now();
+        emit_ns[0] = std::min<int64_t>(emit_ns[0], std::chrono::duration_cast<std::chrono::nanoseconds>(time_mid - time_start).count() / emit_count);
+        emit_ns[1] = std::min<int64_t>(emit_ns[1], std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_mid).count() / emit_count);
+
+        // what a caller does with the list next, copying and ordering it
+        std::vector<Piece> sorted_pieces;
+        std::vector<Placement> sorted_placements;
+        time_start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < count; ++n) {
+            sorted_pieces = pieces;
+            std::sort(sorted_pieces.begin(), sorted_pieces.end(), [](const Piece& a, const Piece& b) { return a.hash() < b.hash(); });
+            checksum += sorted_pieces.front().hash();
+        }
+        time_mid = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < count; ++n) {
+            sorted_placements = placements;
+            std::sort(sorted_placements.begin(), sorted_placements.end());
+            checksum += sorted_placements.front().raw();
+        }
+        time_stop = std::chrono::steady_clock::now();
+        sort_ns[0] = std::min<int64_t>(sort_ns[0], std::chrono::duration_cast<std::chrono::nanoseconds>(time_mid - time_start).count() / count);
+        sort_ns[1] = std::min<int64_t>(sort_ns[1], std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_mid).count() / count);
+    }
+
+    bool same = pieces.size() == placements.size();
+    for (size_t i = 0; same && i < pieces.size(); ++i) {
+        const Piece back = placements[i].to_piece();
+        same = back.type == pieces[i].type && back.rotation == pieces[i].rotation && back.spin == pieces[i].spin &&
+            back.position.x == pieces[i].position.x && back.position.y == pieces[i].position.y;
+    }
+
+    std::cout << "moves: " << pieces.size() << "\tsame moves: " << (same ? "yes" : "NO") << "\tchecksum: " << checksum << std::endl;
+    std::cout << "Piece:     " << pieces.size() * sizeof(Piece) << " bytes, emit " << emit_ns[0] << " ns, copy and sort " << sort_ns[0] << " ns per list" << std::endl;
+    std::cout << "Placement: " << placements.size() * sizeof(Placement) << " bytes, emit " << emit_ns[1] << " ns, copy and sort " << sort_ns[1] << " ns per list" << std::endl;
+}
+
+// drawing placements straight from the bitboards against a full movegen, plus a check that the draws are fair
+static void sample_bench(const Board& board) {
+    using namespace Shaktris::MoveGen::Sampling;
+
+    Game game;
+    game.current_piece = PieceType::T;
+    game.queue = { PieceType::I, PieceType::O, PieceType::L, PieceType::J, PieceType::S, PieceType::Z };
+    game.board = board;
+
+    std::vector<Placement> all;
+    game.get_possible_placements(all);
+    std::sort(all.begin(), all.end());
+
+    RNG rng;
+    rng.PPTRNG = 12345;
+
+    constexpr size_t count = 200'000;
+    std::vector<size_t> hits(all.size());
+    bool legal = true;
+    size_t checksum = 0;
+
+    auto time_start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < count; ++n) {
+        std::vector<Placement> moves;
+        game.get_possible_placements(moves);
+        checksum += moves[rng.getRand((u32)moves.size())].raw();
+    }
+    auto time_mid = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < count; ++n) {
+        std::array<PlacementSet, 2> sets;
+        const size_t used = placement_sets(game, sets);
+        checksum += sample(std::span<const PlacementSet>(sets.data(), used), rng).raw();
+    }
+    auto time_set = std::chrono::steady_clock::now();
+
+    // rollouts that keep drawing from the same position only build the sets once
+    std::array<PlacementSet, 2> sets;
+    const std::span<const PlacementSet> built(sets.data(), placement_sets(game, sets));
+    for (size_t n = 0; n < count; ++n) {
+        const Placement move = sample(built, rng);
+        auto it = std::lower_bound(all.begin(), all.end(), move);
+        if (it == all.end() || *it != move)
+            legal = false;
+        else
+            hits[size_t(it - all.begin())]++;
+    }
+    auto time_stop = std::chrono::steady_clock::now();
+
+    // chi squared against a uniform draw, about the number of moves when the draw is fair
+    const double expected = double(count) / all.size();
+    double chi2 = 0;
+    for (size_t hit : hits)
+        chi2 += (hit - expected) * (hit - expected) / expected;
+
+    // distinct draws never repeat and stop when the moves run out
+    VersusGame versus;
+    versus.p1_game = game;
+    std::array<Placement, 1024> drawn;
+    const size_t distinct = versus.sample_moves(0, rng, drawn);
+    std::sort(drawn.begin(), drawn.begin() + distinct);
+    const bool no_repeats = std::adjacent_find(drawn.begin(), drawn.begin() + distinct) == drawn.begin() + distinct;
+
+    std::cout << "moves: " << all.size() << "\tall draws legal: " << (legal ? "yes" : "NO") << "\tchi2: " << chi2 << " (" << all.size() - 1 << " dof)" << std::endl;
+    // get_N_moves stays on the Traditional list, asking for more than there are gives every one of them
+    const size_t traditional = versus.get_moves(0).size() / 2;
+    const bool whole_list = versus.get_N_moves(0, 1000, rng).size() == traditional && versus.get_N_moves(0, 3, rng).size() == std::min<size_t>(3, traditional);
+
+    std::cout << "distinct draws: " << distinct << "\tno repeats: " << (no_repeats ? "yes" : "NO") << "\tget_N_moves from Traditional: " << (whole_list ? "yes" : "NO") << std::endl;
+    std::cout << "movegen + pick:    " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_mid - time_start).count() / count << " ns" << std::endl;
+    std::cout << "build sets + draw: " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_set - time_mid).count() / count << " ns" << std::endl;
+    std::cout << "draw from sets:    " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_set).count() / count << " ns\tchecksum: " << checksum << std::endl;
+}
+
+// the flooded sets against god_movegen's bfs on random low boards with holes and overhangs, spins included
+static void sample_flood_check() {
+    using namespace Shaktris::MoveGen::Sampling;
+
+    RNG rng;
+    rng.PPTRNG = 777;
+    constexpr size_t boards = 5'000;
+    size_t mismatches = 0;
+    size_t flooded = 0;
+    int64_t ns[2] = {};
+
+    for (size_t n = 0; n < boards; ++n) {
+        Board board;
+        for (size_t x = 0; x < Board::width; x++) {
+            const u32 height = rng.getRand(12);
+            column_t col = (column_t(1) << height) - 1;
+            col &= ~(column_t(1) << rng.getRand(height + 1));
+            if (rng.getRand(3) == 0)
+                col |= column_t(1) << (height + 1 + rng.getRand(3));
+            board.board[x] = col;
+        }
+        if (board.surface_convex() || !board.is_low())
+            continue;
+        flooded++;
+
+        for (size_t type = 0; type < (size_t)PieceType::Empty; ++type) {
+            auto time_start = std::chrono::steady_clock::now();
+            PlacementSet expected;
+            Shaktris::MoveGen::Smeared::god_movegen(board, (PieceType)type, [&](Placement placement) {
+                const column_t bit = column_t(1) << placement.position().y;
+                expected.moves.boards[placement.rotation()].board[(size_t)placement.position().x] |= bit;
+                if (placement.spin() != spinType::null)
+                    expected.spins.boards[placement.rotation()].board[(size_t)placement.position().x] |= bit;
+            });
+            auto time_mid = std::chrono::steady_clock::now();
+            const PlacementSet got = placement_set(board, (PieceType)type);
+            auto time_stop = std::chrono::steady_clock::now();
+            ns[0] += std::chrono::duration_cast<std::chrono::nanoseconds>(time_mid - time_start).count();
+            ns[1] += std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_mid).count();
+
+            mismatches += !(got.moves == expected.moves && got.spins == expected.spins);
+        }
+    }
+
+    const size_t sets = flooded * (size_t)PieceType::Empty;
+    std::cout << "flooded sets match god_movegen: " << (mismatches == 0 ? "yes" : "NO") << " (" << mismatches << "/" << sets << " differ)"
+        << "\tgod_movegen bfs: " << ns[0] / (int64_t)sets << " ns\tflood: " << ns[1] / (int64_t)sets << " ns per piece" << std::endl;
+}
+
+void sample_bench() {
+    sample_flood_check();
+
+    Board low;
+    low.board = { 0b111111, 0b111111, 0b011111, 0b001111, 0b000000, 0b011111, 0b111111, 0b111111, 0b111111, 0b111011 };
+    std::cout << "low board" << std::endl;
+    sample_bench(low);
+
+    Board tall;
+    tall.board = { 0b111111111100, 0b110000001100, 0b110000001100, 0b110011001100, 0b110011001100,
+        0b110011001100, 0b110011001100, 0b110011001100, 0b000011000000, 0b000011111111 };
+    std::cout << "overhangs" << std::endl;
+    sample_bench(tall);
+}
+
+// bulk bags against one getPiece at a time, for both generators, and what seeding saves when making games
+template <class Rng>
+static bool rng_bench(const char* name, Rng one_at_a_time, Rng bulk) {
+    constexpr size_t count = 1 << 20;
+    std::vector<PieceType> expected(count);
+    std::vector<PieceType> got(count);
+
+    auto time_start = std::chrono::steady_clock::now();
+    for (auto& piece : expected)
+        piece = one_at_a_time.getPiece();
+    auto time_mid = std::chrono::steady_clock::now();
+
+    // odd sized chunks so partial bags at both ends get exercised
+    size_t filled = 0;
+    for (size_t chunk = 1; filled < count; chunk = chunk * 3 + 1) {
+        const size_t n = std::min(chunk % 4099, count - filled);
+        bulk.fill_bags(std::span(got).subspan(filled, n));
+        filled += n;
+    }
+    auto time_stop = std::chrono::steady_clock::now();
+
+    const bool same = expected == got && one_at_a_time.getPiece() == bulk.getPiece();
+    std::cout << name << " getPiece: " << std::chrono::duration_cast<std::chrono::microseconds>(time_mid - time_start).count() << "us\tfill_bags: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(time_stop - time_mid).count() << "us\tsame pieces: " << (same ? "yes" : "NO") << std::endl;
+    return same;
+}
+
+void rng_bench() {
+    rng_bench("RNG       ", RNG(12345), RNG(12345));
+    rng_bench("CounterRNG", CounterRNG(12345), CounterRNG(12345));
+    rng_bench("Bag14     ", Bag14(12345), Bag14(12345));
+    rng_bench("PureRandom", PureRandom(12345), PureRandom(12345));
+    rng_bench("NesReroll ", NesReroll(12345), NesReroll(12345));
+
+    // each randomizer keeps its promise about the sequence
+    {
+        std::vector<PieceType> pieces(14 * 1000);
+        Bag14 bag14(1);
+        bag14.fill_bags(pieces);
+        bool whole_bags = true;
+        for (size_t b = 0; b < pieces.size(); b += 14) {
+            std::array<int, 7> seen{};
+            for (size_t i = b; i < b + 14; ++i)
+                seen[(size_t)pieces[i]]++;
+            whole_bags &= std::all_of(seen.begin(), seen.end(), [](int n) { return n == 2; });
+        }
+
+        NesReroll nes(1);
+        nes.fill_bags(pieces);
+        size_t repeats = 0;
+        for (size_t i = 1; i < pieces.size(); ++i)
+            repeats += pieces[i] == pieces[i - 1];
+
+        std::cout << "Bag14 has two of each per bag: " << (whole_bags ? "yes" : "NO") << "\tNES repeat rate: " << double(repeats) / (pieces.size() - 1)
+            << " (1/28 = " << 1.0 / 28 << ")" << std::endl;
+    }
+
+    // splitting is deterministic and the children do not repeat their parent
+    RNG parent(12345), parent_again(12345);
+    RNG child = parent.split(), child_again = parent_again.split();
+    CounterRNG counter_parent(12345), counter_parent_again(12345);
+    CounterRNG counter_child = counter_parent.split(), counter_child_again = counter_parent_again.split();
+    const bool deterministic = child.PPTRNG == child_again.PPTRNG && counter_child.key == counter_child_again.key;
+    const bool differs = child.PPTRNG != parent.PPTRNG && counter_child.key != counter_parent.key;
+    std::cout << "split deterministic: " << (deterministic ? "yes" : "NO") << "\tchild differs: " << (differs ? "yes" : "NO") << std::endl;
+
+    constexpr size_t games = 10'000;
+    size_t checksum = 0;
+    auto time_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < games; ++i) {
+        VersusGame game;
+        checksum += game.p1_rng.PPTRNG;
+    }
+    auto time_mid = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < games; ++i) {
+        VersusGame game((u32)i);
+        checksum += (size_t)game.p1_game.current_piece.type;
+    }
+    auto time_stop = std::chrono::steady_clock::now();
+
+    std::cout << "VersusGame from random_device: " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_mid - time_start).count() / games << " ns\t"
+        << "seeded and dealt: " << std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_mid).count() / games << " ns\tchecksum: " << checksum << std::endl;
+}
+
+// walks the tree of a Game by copying every child
+static Nodes game_perft_copy(const Game& game, int depth) {
+    if (depth == 0 || game.current_piece.type == PieceType::Empty)
+        return 1;
+
+    Nodes nodes = 0;
+    for (const Piece& move : game.get_possible_piece_placements()) {
+        Game child = game;
+        child.place_piece(move);
+        int lines = child.board.clearLines();
+        child.damage_sent(lines, move.spin, child.board.is_empty());
+        nodes += game_perft_copy(child, depth - 1);
+    }
+    return nodes;
+}
+
+// same walk with a single Game, the checking version also makes sure every unmake lands exactly where make started
+// the timed runs do not check, so they do the same work per node as the copying walk
+template <bool Check, class Mode, std::size_t Preview>
+static Nodes game_perft_make(BasicGame<Mode, Preview>& game, int depth, bool& exact) {
+    if (depth == 0 || game.current_piece.type == PieceType::Empty)
+        return 1;
+
+    Nodes nodes = 0;
+    for (const Piece& move : game.get_possible_piece_placements()) {
+        u64 before = 0;
+        Board board_before;
+        if constexpr (Check) {
+            before = game.hash();
+            board_before = game.board;
+        }
+
+        auto undo = game.make(move);
+        nodes += game_perft_make<Check>(game, depth - 1, exact);
+        game.unmake(undo);
+
+        if constexpr (Check) {
+            exact &= game.hash() == before && game.board == board_before;
+            exact &= GameState::from(GameState::from(game).template to_game<Mode, Preview>()) == GameState::from(game);
+        }
+    }
+    return nodes;
+}
+
+void make_bench() {
+    Game game;
+    game.mode = TetrioS1();
+    game.current_piece = PieceType::T;
+    game.queue = { PieceType::I, PieceType::O, PieceType::L, PieceType::J, PieceType::S, PieceType::Z };
+    game.board.board = { 0b1111, 0b1111, 0b0111, 0b0011, 0b0000, 0b0111, 0b1111, 0b1111, 0b1111, 0b1111 };
+
+    constexpr int depth = 3;
+    bool exact = true;
+
+    // same game with the mode fixed at compile time, damage_sent calls TetrioS1 directly
+    BasicGame<TetrioS1> fixed = GameState::from(game).to_game<TetrioS1>();
+    // a long preview for lookahead, placing should cost the same as with six
+    BasicGame<TetrioS1, 18> long_preview = GameState::from(game).to_game<TetrioS1, 18>();
+
+    auto time_start = std::chrono::steady_clock::now();
+    Nodes copied = game_perft_copy(game, depth);
+    auto time_mid = std::chrono::steady_clock::now();
+    Nodes made = game_perft_make<false>(game, depth, exact);
+    auto time_stop = std::chrono::steady_clock::now();
+
+    auto time_fixed_start = std::chrono::steady_clock::now();
+    Nodes fixed_made = game_perft_make<false>(fixed, depth, exact);
+    auto time_fixed_stop = std::chrono::steady_clock::now();
+
+    auto time_long_start = std::chrono::steady_clock::now();
+    Nodes long_made = game_perft_make<false>(long_preview, depth, exact);
+    auto time_long_stop = std::chrono::steady_clock::now();
+
+    // untimed pass over the same trees with the unmake and round trip checks
+    exact &= game_perft_make<true>(game, depth, exact) == made;
+    exact &= game_perft_make<true>(fixed, depth, exact) == made && fixed.hash() == game.hash();
+    exact &= game_perft_make<true>(long_preview, depth, exact) == made;
+    exact &= copied == made && fixed_made == made && long_made == made;
+
+    std::cout << "copy:        " << copied << " nodes in " << std::chrono::duration_cast<std::chrono::milliseconds>(time_mid - time_start).count() << "ms" << std::endl;
+    std::cout << "make/unmake: " << made << " nodes in " << std::chrono::duration_cast<std::chrono::milliseconds>(time_stop - time_mid).count() << "ms" << std::endl;
+    std::cout << "fixed mode:  " << fixed_made << " nodes in " << std::chrono::duration_cast<std::chrono::milliseconds>(time_fixed_stop - time_fixed_start).count() << "ms" << std::endl;
+    std::cout << "preview 18:  " << long_made << " nodes in " << std::chrono::duration_cast<std::chrono::milliseconds>(time_long_stop - time_long_start).count() << "ms" << std::endl;
+    std::cout << "unmake and GameState round trip exact: " << (exact ? "yes" : "NO") << std::endl;
+    std::cout << "sizeof(Game): " << sizeof(Game) << "\tsizeof(GameState): " << sizeof(GameState) << std::endl;
+}
+
+// TetrioS1::points and Botris::points as they were before the lookup tables, kept to check the tables against
+static std::size_t tetrio_formula(TetrioS1& mode, int linesCleared, spinType spin, bool pc, u16& combo, u16& b2b) {
+    using GarbageValues = decltype(TetrioS1::GarbageValues);
+    auto maintainsB2B = false;
+
+    if (linesCleared) {
+        combo++;
+        if (4 == linesCleared || spin != spinType::null)
+            maintainsB2B = true;
+
+        if (maintainsB2B)
+            b2b++;
+        else
+            b2b = 0;
+    }
+    else {
+        combo = 0;
+        mode.currentcombopower = 0;
+    }
+
+    int garbage = 0;
+
+    switch (linesCleared) {
+    case 0:
+        if (spinType::mini == spin)
+            garbage = GarbageValues::TSPIN_MINI;
+        else if (spinType::normal == spin)
+            garbage = GarbageValues::TSPIN;
+        break;
+    case 1:
+        if (spinType::mini == spin)
+            garbage = GarbageValues::TSPIN_MINI_SINGLE;
+        else if (spinType::normal == spin)
+            garbage = GarbageValues::TSPIN_SINGLE;
+        else
+            garbage = GarbageValues::SINGLE;
+        break;
+    case 2:
+        if (spinType::mini == spin)
+            garbage = GarbageValues::TSPIN_MINI_DOUBLE;
+        else if (spinType::normal == spin)
+            garbage = GarbageValues::TSPIN_DOUBLE;
+        else
+            garbage = GarbageValues::DOUBLE;
+        break;
+    case 3:
+        garbage = spin != spinType::null ? GarbageValues::TSPIN_TRIPLE : GarbageValues::TRIPLE;
+        break;
+    case 4:
+        garbage = spin != spinType::null ? GarbageValues::TSPIN_QUAD : GarbageValues::QUAD;
+        break;
+    }
+
+    if (linesCleared) {
+        if (b2b > 1) {
+            const int b2bGarbage = GarbageValues::BACKTOBACK_BONUS *
+                (1 + std::log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG) + (b2b - 1 <= 1 ? 0 : (1 + std::log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG) - (int)std::log1p((b2b - 1) * GarbageValues::BACKTOBACK_BONUS_LOG)) / 3));
+
+            garbage += b2bGarbage;
+
+            if (b2bGarbage > mode.currentbtbchainpower)
+                mode.currentbtbchainpower = b2bGarbage;
+        }
+        else
+            mode.currentbtbchainpower = 0;
+    }
+
+    if (combo > 1)
+        garbage *= 1 + GarbageValues::COMBO_BONUS * (combo - 1);
+
+    if (combo > 2)
+        garbage = std::max((int)std::log1p(GarbageValues::COMBO_MINIFIER * (combo - 1) * GarbageValues::COMBO_MINIFIER_LOG), garbage);
+
+    const int finalGarbage = garbage * TetrioS1::options.garbagemultiplier;
+    if (combo > 2)
+        mode.currentcombopower = std::max((int)mode.currentcombopower, finalGarbage);
+
+    return finalGarbage + (pc ? GarbageValues::ALL_CLEAR : 0);
+}
+
+static std::size_t botris_formula(int linesCleared, spinType spin, bool pc, u16& combo, u16& b2b) {
+    std::size_t garbage = 0;
+
+    if (linesCleared) {
+        combo++;
+        b2b = 4 == linesCleared || spin != spinType::null;
+
+        garbage += Botris::attack_table[static_cast<size_t>(linesCleared)];
+        if (spin == spinType::normal)
+            garbage += Botris::all_spin_bonus[static_cast<size_t>(linesCleared)];
+        garbage += Botris::combo_table[std::min(Botris::combo_table.size() - 1, static_cast<size_t>(combo))];
+        if (pc)
+            garbage += Botris::pc_bonus;
+        if (b2b)
+            garbage += Botris::b2b_bonus;
+    }
+    else {
+        combo = 0;
+    }
+
+    return garbage;
+}
+
+// every clear inside the tables and a good way past them, the tables have to match the formulas exactly
+void attack_bench() {
+    std::size_t checked = 0;
+    std::size_t mismatches = 0;
+
+    for (int lines = 0; lines <= 4; ++lines) {
+        for (int spin = 0; spin < 3; ++spin) {
+            for (int pc = 0; pc < 2; ++pc) {
+                for (u16 combo = 0; combo < TetrioS1::table_combo + 16; ++combo) {
+                    for (u16 b2b = 0; b2b < TetrioS1::table_b2b + 16; ++b2b) {
+                        for (u16 power : { 0, 3, 40 }) {
+                            TetrioS1 table_mode;
+                            table_mode.currentcombopower = power;
+                            table_mode.currentbtbchainpower = power;
+                            TetrioS1 formula_mode = table_mode;
+
+                            u16 table_combo = combo, table_b2b = b2b;
+                            u16 formula_combo = combo, formula_b2b = b2b;
+
+                            const std::size_t from_table = table_mode.points(lines, (spinType)spin, pc, table_combo, table_b2b);
+                            const std::size_t from_formula = tetrio_formula(formula_mode, lines, (spinType)spin, pc, formula_combo, formula_b2b);
+
+                            mismatches += from_table != from_formula || table_combo != formula_combo || table_b2b != formula_b2b ||
+                                table_mode.currentcombopower != formula_mode.currentcombopower ||
+                                table_mode.currentbtbchainpower != formula_mode.currentbtbchainpower;
+                            checked++;
+                        }
+
+                        if (b2b < 2) {
+                            Botris table_mode;
+                            u16 table_combo = combo, table_b2b = b2b;
+                            u16 formula_combo = combo, formula_b2b = b2b;
+
+                            const std::size_t from_table = table_mode.points(lines, (spinType)spin, pc, table_combo, table_b2b);
+                            const std::size_t from_formula = botris_formula(lines, (spinType)spin, pc, formula_combo, formula_b2b);
+
+                            mismatches += from_table != from_formula || table_combo != formula_combo || table_b2b != formula_b2b;
+                            checked++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "checked " << checked << " clears, mismatches: " << mismatches << std::endl;
+
+    // a long run of clears through both, the way search calls it
+    constexpr int count = 1 << 22;
+    std::vector<u8> clears(count);
+    RNG rng;
+    for (auto& clear : clears)
+        clear = (u8)(rng.getRand(5) | (rng.getRand(3) << 3));
+
+    std::size_t sums[2] = {};
+    std::chrono::steady_clock::duration times[2];
+    for (int pass = 0; pass < 2; ++pass) {
+        TetrioS1 mode;
+        u16 combo = 0, b2b = 0;
+        auto time_start = std::chrono::steady_clock::now();
+        for (u8 clear : clears) {
+            const int lines = clear & 7;
+            const spinType spin = (spinType)(clear >> 3);
+            sums[pass] += pass == 0 ? tetrio_formula(mode, lines, spin, false, combo, b2b) : mode.points(lines, spin, false, combo, b2b);
+        }
+        times[pass] = std::chrono::steady_clock::now() - time_start;
+    }
+
+    std::cout << "formula: " << std::chrono::duration_cast<std::chrono::microseconds>(times[0]).count() << "us\ttable: "
+        << std::chrono::duration_cast<std::chrono::microseconds>(times[1]).count() << "us\tsame total: " << (sums[0] == sums[1] ? "yes" : "NO") << std::endl;
+}
+
+// self play across the pool, checked against the same games played one at a time
+template <class Policy>
+static void selfplay_bench(const char* name, Policy policy, std::size_t games, int max_turns) {
+    constexpr u64 seed = 12345;
+
+    ThreadPool pool;
+
+    BatchSimulator<RNG> batch(pool, games, seed);
+    auto time_start = std::chrono::steady_clock::now();
+    SelfPlayStats stats = batch.run(policy, max_turns);
+    auto time_stop = std::chrono::steady_clock::now();
+
+    // sequential, the same games on a single thread through the same turn
+    ThreadPool single(1);
+    BatchSimulator<RNG> sequential(single, games, seed);
+    auto time_seq_start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < games; ++i) {
+        for (int turn = 0; turn < max_turns; ++turn)
+            if (!BatchSimulator<RNG>::step(sequential.games[i], sequential.outcomes[i], policy, sequential.policy_rngs[i]))
+                break;
+    }
+    auto time_seq_stop = std::chrono::steady_clock::now();
+
+    bool identical = true;
+    for (std::size_t i = 0; i < games; ++i) {
+        identical &= batch.outcomes[i] == sequential.outcomes[i] && batch.games[i].turn == sequential.games[i].turn &&
+            batch.games[i].p1_game.hash() == sequential.games[i].p1_game.hash() &&
+            batch.games[i].p2_game.hash() == sequential.games[i].p2_game.hash();
+    }
+
+    const double batch_us = (double)std::chrono::duration_cast<std::chrono::microseconds>(time_stop - time_start).count();
+    const double seq_us = (double)std::chrono::duration_cast<std::chrono::microseconds>(time_seq_stop - time_seq_start).count();
+
+    std::cout << name << std::endl;
+    std::cout << "\tgames: " << stats.games << "\tfinished: " << stats.finished << "\tturns mean " << stats.mean_turns() << " min " << stats.min_turns
+              << " max " << stats.max_turns << std::endl;
+    std::cout << "\tapp p1: " << stats.app(0) << "\tp2: " << stats.app(1) << "\twinrate p1: " << stats.winrate(0) << std::endl;
+    std::cout << "\tbatched:    " << stats.pieces << " pieces in " << batch_us / 1000 << "ms, " << stats.pieces / batch_us << "M pieces/s on "
+              << pool.size() << " threads" << std::endl;
+    std::cout << "\tsequential: " << seq_us / 1000 << "ms, " << stats.pieces / seq_us << "M pieces/s" << std::endl;
+    std::cout << "\tidentical to sequential play: " << (identical ? "yes" : "NO") << std::endl;
+}
+
+void selfplay_bench() {
+    selfplay_bench("drop policy", DropPolicy(), 16384, 1000);
+    selfplay_bench("random placement policy", RandomPolicy(), 2048, 1000);
+
+    // neither policy sends much, so a scripted game checks the attack totals: player 1 has an eight deep well and two I pieces,
+    // and clears as many lines as it can while player 2 clears as few as it can
+    // a quad sends 4, then a b2b quad on combo 1 sends (4 + 1) * 1.25 floored to 6, and a leftover cell keeps it from being an all clear
+    VersusGame game(1);
+    Board well;
+    for (std::size_t x = 1; x < Board::width; ++x)
+        well.board[x] = 0b11111111;
+    well.board[Board::width - 1] |= 1 << 8;
+    game.p1_game.board = well;
+    game.p1_game.mode = TetrioS1();
+    game.p2_game.mode = TetrioS1();
+    game.p1_game.current_piece = Piece(PieceType::I);
+    game.p1_game.queue = { PieceType::I, PieceType::T, PieceType::T, PieceType::T, PieceType::T, PieceType::T };
+
+    auto scripted = [](const VersusGame& game, int id, RNG&) {
+        const Game& player = game.get_game(id);
+        Move best;
+        int best_lines = -1;
+        for (const Piece& piece : player.get_possible_piece_placements()) {
+            Board board = player.board;
+            board.set(piece);
+            const int lines = id == 0 ? board.clearLines() : -board.clearLines();
+            if (lines > best_lines) {
+                best = Move(piece, false);
+                best_lines = lines;
+            }
+        }
+        return best;
+    };
+    std::array<VersusGame, 1> games{ game };
+    std::array<Outcomes, 1> outcomes{ Outcomes::NONE };
+    RNG rng(1);
+    for (int turn = 0; turn < 2; ++turn)
+        BatchSimulator<RNG>::step(games[0], outcomes[0], scripted, rng);
+    const SelfPlayStats stats = BatchSimulator<RNG>::stats(games, outcomes);
+
+    const bool totals = stats.pieces == 4 && stats.p1_attack == 10 && stats.p2_attack == 0 && stats.app(0) == 5 && stats.app(1) == 0 &&
+                        games[0].p1_game.b2b == 2 && games[0].p1_game.board.board[Board::width - 1] == 1;
+    std::cout << "scripted quads: attack p1 " << stats.p1_attack << " p2 " << stats.p2_attack << "\tapp p1 " << stats.app(0)
+              << "\tb2b " << games[0].p1_game.b2b << "\ttotals as expected: " << (totals ? "yes" : "NO") << std::endl;
+}
+
+// steps a batch of envs with cheap random placements, checks the observations against Board::get
+void env_bench() {
+    using Env = VecEnv<RNG>;
+    constexpr std::size_t envs = 1024;
+    constexpr int steps = 2000;
+
+    Env env(envs, 12345);
+    std::vector<float> obs(env.agents() * Env::obs_size);
+    std::vector<float> rewards(env.agents());
+    std::vector<u8> dones(envs);
+    std::vector<Placement> actions(env.agents());
+    std::vector<RNG> rngs;
+    for (std::size_t i = 0; i < envs; ++i)
+        rngs.emplace_back((u32)i);
+
+    env.reset(obs);
+
+    DropPolicy policy;
+    u64 episodes = 0;
+    double total_reward = 0;
+    bool obs_match = true;
+    std::size_t hot_allocations = 0;
+    std::int64_t step_ns = 0;
+
+    for (int step = 0; step < steps; ++step) {
+        for (std::size_t i = 0; i < envs; ++i) {
+            for (int id = 0; id < 2; ++id) {
+                const Move move = policy(env.games[i], id, rngs[i]);
+                actions[i * 2 + id] = move.null_move ? Placement() : Placement(move.piece);
+            }
+        }
+
+        const std::size_t before = allocations.load(std::memory_order_relaxed);
+        auto time_start = std::chrono::steady_clock::now();
+        env.step(actions, obs, rewards, dones);
+        auto time_stop = std::chrono::steady_clock::now();
+        hot_allocations += allocations.load(std::memory_order_relaxed) - before;
+        step_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_start).count();
+
+        for (std::size_t i = 0; i < envs; ++i)
+            episodes += dones[i];
+        for (float reward : rewards)
+            total_reward += reward;
+
+        // the slow way, one cell at a time
+        if (step % 100 == 0) {
+            for (std::size_t i = 0; i < env.agents(); ++i) {
+                const Game& game = env.games[i / 2].get_game((int)(i % 2));
+                const float* agent = obs.data() + i * Env::obs_size;
+                for (std::size_t x = 0; x < Board::width; ++x)
+                    for (std::size_t y = 0; y < Board::height; ++y)
+                        obs_match &= agent[Env::own_board_offset + x * Board::height + y] == (game.board.get(x, y) ? 1.0f : 0.0f);
+                for (std::size_t t = 0; t < Env::piece_types; ++t)
+                    obs_match &= agent[Env::current_offset + t] == (t == (std::size_t)game.current_piece.type ? 1.0f : 0.0f);
+            }
+        }
+    }
+
+    const double agent_steps = double(steps) * env.agents();
+    std::cout << "envs: " << envs << "\tsteps: " << steps << "\tepisodes finished: " << episodes << "\tmean reward: " << total_reward / agent_steps << std::endl;
+    std::cout << "step: " << step_ns / steps / 1000 << " us per batch, " << step_ns / agent_steps << " ns per agent step" << std::endl;
+    std::cout << "allocations while stepping: " << hot_allocations << std::endl;
+    std::cout << "observations match Board::get: " << (obs_match ? "yes" : "NO") << std::endl;
+
+    // a placement resting on the floor of a sealed cave is not reachable, and a claimed spin is replaced by the board's
+    Env sealed(1, 99);
+    std::vector<float> sealed_obs(sealed.agents() * Env::obs_size);
+    std::array<float, 2> sealed_rewards;
+    std::array<u8, 1> sealed_dones;
+    sealed.reset(sealed_obs);
+    Game& cave = sealed.games[0].p1_game;
+    for (column_t& column : cave.board.board)
+        column = column_t(1) << 5;
+    const std::array<Placement, 2> sealed_actions = {
+        Placement(cave.current_piece.type, RotationDirection::North, Coord(4, 0)),
+        Placement(sealed.games[0].p2_game.current_piece.type, RotationDirection::North, Coord(4, 0), spinType::normal)
+    };
+    const std::optional<Placement> resolved = Env::legal(sealed.games[0].p2_game, sealed_actions[1]);
+    bool reachability = !Env::legal(cave, sealed_actions[0]) && resolved && resolved->spin() == spinType::null;
+    sealed.step(sealed_actions, sealed_obs, sealed_rewards, sealed_dones);
+    reachability &= sealed_dones[0] && sealed_rewards[0] < 0 && sealed_rewards[1] > 0;
+    std::cout << "unreachable placement loses, claimed spin ignored: " << (reachability ? "yes" : "NO") << std::endl;
+}
+
+// fixed shape masks against the placement lists they replace
+static void mask_bench(const Board& board) {
+    using namespace Shaktris::ActionMask;
+    constexpr int rounds = 10;
+    constexpr int iterations = 2000;
+
+    Game game;
+    game.board = board;
+    game.current_piece = PieceType::T;
+    game.queue = { PieceType::S, PieceType::O, PieceType::L, PieceType::J, PieceType::I, PieceType::Z };
+
+    // the two sides take turns and each keeps its best round, one long run of each swings too much with the machine's load
+    std::int64_t checksum = 0;
+    std::int64_t lists_ns = std::numeric_limits<std::int64_t>::max();
+    std::int64_t masks_ns = std::numeric_limits<std::int64_t>::max();
+    std::array<u64, words> bits;
+    for (int round = 0; round < rounds; ++round) {
+        auto time_start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            checksum += (std::int64_t)game.get_possible_piece_placements().size();
+        auto time_mid = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            masks(game).write(bits);
+            checksum += std::popcount(bits[i % words]);
+        }
+        auto time_stop = std::chrono::steady_clock::now();
+        lists_ns = std::min(lists_ns, (std::int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(time_mid - time_start).count() / iterations);
+        masks_ns = std::min(masks_ns, (std::int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_mid).count() / iterations);
+    }
+
+    // every placement has its action and every action its placement
+    const Masks m = masks(game);
+    const std::vector<Piece> pieces = game.get_possible_piece_placements();
+    bool matches = m.count() == pieces.size();
+    for (const Piece& piece : pieces) {
+        const std::size_t action = m.action(Placement(piece));
+        matches &= m.legal(action) && m.placement(action) == Placement(piece);
+    }
+    std::array<u8, size> bytes;
+    m.write(bytes);
+    m.write(bits);
+    for (std::size_t action = 0; action < size; ++action)
+        matches &= bool(bytes[action]) == m.legal(action) && bool((bits[action / 64] >> (action % 64)) & 1) == m.legal(action);
+
+    std::cout << "\tplacement lists: " << lists_ns << " ns"
+              << "\tmasks: " << masks_ns << " ns (" << (double)masks_ns / lists_ns << "x)"
+              << "\tactions: " << m.count() << "\tmatch: " << (matches ? "yes" : "NO") << "\t(" << checksum % 10 << ")" << std::endl;
+}
+
+void mask_bench() {
+    Board low;
+    low.board = { 0b111111, 0b111111, 0b011111, 0b001111, 0b000000, 0b011111, 0b111111, 0b111111, 0b111111, 0b111011 };
+    std::cout << "low board" << std::endl;
+    mask_bench(low);
+
+    Board tall;
+    tall.board = { 0b111111111100, 0b110000001100, 0b110000001100, 0b110011001100, 0b110011001100,
+        0b110011001100, 0b110011001100, 0b110011001100, 0b000011000000, 0b000011111111 };
+    std::cout << "overhangs" << std::endl;
+    mask_bench(tall);
+}
+
+// records self play games, then rebuilds random turns from the file and checks them against the live games
+void replay_bench() {
+    constexpr int games = 500;
+    constexpr u32 keyframe_interval = 8;
+    const char* path = "replay_bench.shkr";
+
+    DropPolicy policy;
+    std::vector<u64> hashes;
+    std::size_t record_allocations = 0;
+    u64 turns = 0;
+    u64 bytes = 0;
+    u64 checked = 0;
+    bool matches = true;
+    std::int64_t rebuild_ns = 0;
+
+    for (int g = 0; g < games; ++g) {
+        const u32 seed = (u32)hash_mix((u64)g);
+        VersusGame game(seed);
+        if (g % 2)
+            game.p1_game.mode = TetrioS1();
+        RNG rng(seed);
+
+        ReplayWriter writer;
+        if (!writer.open(path, game, seed, seed, keyframe_interval)) {
+            std::cout << "could not write " << path << std::endl;
+            return;
+        }
+        game.recorder = &writer;
+
+        hashes.assign(1, hash_combine(game.p1_game.hash(), game.p2_game.hash()));
+        while (!game.game_over) {
+            const Move p1 = policy(game, 0, rng);
+            const Move p2 = policy(game, 1, rng);
+            if (p1.null_move || p2.null_move)
+                break;
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+
+            const std::size_t before = allocations.load(std::memory_order_relaxed);
+            game.play_moves();
+            record_allocations += allocations.load(std::memory_order_relaxed) - before;
+            hashes.push_back(hash_combine(game.p1_game.hash(), game.p2_game.hash()));
+        }
+        matches &= writer.close();
+        turns += writer.turns_written();
+
+        ReplayReader reader;
+        matches &= reader.open(path) && reader.turns() == writer.turns_written();
+        bytes += reader.bytes().size();
+
+        // every turn, in a scrambled order so keyframes get jumped between
+        VersusGame rebuilt(0);
+        for (u64 i = 0; i <= reader.turns(); ++i) {
+            const u64 t = (i * 7919) % (reader.turns() + 1);
+            auto time_start = std::chrono::steady_clock::now();
+            matches &= reader.state_at(t, rebuilt);
+            rebuild_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_start).count();
+            matches &= hash_combine(rebuilt.p1_game.hash(), rebuilt.p2_game.hash()) == hashes[t] && rebuilt.turn == (int)t;
+            checked++;
+        }
+    }
+    std::remove(path);
+
+    std::cout << "games: " << games << "\tturns: " << turns << "\tbytes per turn: " << (double)bytes / turns << " (keyframe every " << keyframe_interval << ")" << std::endl;
+    std::cout << "allocations while recording: " << record_allocations << std::endl;
+    std::cout << "random access: " << rebuild_ns / (std::int64_t)checked << " ns per turn rebuilt" << std::endl;
+    std::cout << "every rebuilt turn matches the game: " << (matches ? "yes" : "NO") << std::endl;
+}
+
+// order independent checksum and count of every record in the shards of a prefix
+static bool read_shards(const std::string& prefix, std::size_t shards, u64& records, u64& checksum) {
+    std::vector<Shaktris::DataGen::Record> block;
+    for (std::size_t i = 0; i < shards; ++i) {
+        const std::string path = Shaktris::DataGen::shard_path(prefix, i);
+        Shaktris::DataGen::ShardReader reader;
+        if (!reader.open(path))
+            return false;
+        for (std::size_t b = 0; b < reader.blocks(); ++b) {
+            block.clear();
+            if (!reader.read_block(b, block))
+                return false;
+            for (const Shaktris::DataGen::Record& record : block) {
+                std::array<u64, sizeof(record) / sizeof(u64)> words;
+                std::memcpy(words.data(), &record, sizeof(record));
+                u64 h = 0;
+                for (u64 word : words)
+                    h = hash_combine(h, word);
+                checksum += h;
+                records++;
+            }
+        }
+        std::remove(path.c_str());
+    }
+    return true;
+}
+
+// self play into shards, once compressed on every core and once raw on three threads, both read back
+void datagen_bench() {
+    using namespace Shaktris::DataGen;
+
+    DataGenConfig config;
+    config.seed = 12345;
+    config.games = 16384;
+    config.records_per_shard = 1 << 16;
+
+    DropPolicy policy;
+    ThreadPool pool;
+    config.prefix = "datagen_bench_packed";
+    const DataGenStats packed = generate(pool, config, policy);
+
+    ThreadPool three(3);
+    config.prefix = "datagen_bench_raw";
+    config.compress = false;
+    const DataGenStats raw = generate(three, config, policy);
+
+    u64 packed_records = 0, packed_checksum = 0, raw_records = 0, raw_checksum = 0;
+    bool ok = packed.ok && raw.ok;
+    ok &= read_shards("datagen_bench_packed", packed.shards, packed_records, packed_checksum);
+    ok &= read_shards("datagen_bench_raw", raw.shards, raw_records, raw_checksum);
+    ok &= packed_records == packed.records && raw_records == raw.records && packed_records == raw_records && packed_checksum == raw_checksum;
+
+    std::cout << "games: " << packed.games << "\trecords: " << packed.records << "\tshards: " << packed.shards << std::endl;
+    std::cout << "compressed: " << packed.samples_per_second() / 1e6 << "M samples/s, " << packed.samples_per_second_per_core() / 1e6
+              << "M samples/s per core on " << packed.cores << " cores (" << packed.producers << " producers and the writer), "
+              << (double)packed.bytes / packed.records << " bytes per record (" << packed.compression_ratio() << " of raw)" << std::endl;
+    std::cout << "raw:        " << raw.samples_per_second() / 1e6 << "M samples/s, " << raw.samples_per_second_per_core() / 1e6
+              << "M samples/s per core on " << raw.cores << " cores (" << raw.producers << " producers and the writer)" << std::endl;
+    std::cout << "shards read back to the same records: " << (ok ? "yes" : "NO") << std::endl;
+
+    // the labels have to be actions the masks allow, the drop policy also places south and west states
+    std::size_t labels = 0, outside = 0, twins = 0;
+    RNG rng(config.seed);
+    for (int g = 0; g < 200; ++g) {
+        VersusGame game((u32)hash_mix((u64)g));
+        while (!game.game_over) {
+            const Move p1 = policy(game, 0, rng);
+            const Move p2 = policy(game, 1, rng);
+            if (p1.null_move || p2.null_move)
+                break;
+            for (int id = 0; id < 2; ++id) {
+                const Move& move = id == 0 ? p1 : p2;
+                const Record record = make_record(game, id, move);
+                outside += !Shaktris::ActionMask::masks(game.get_game(id)).legal(record.action);
+                twins += Shaktris::ActionMask::rotation(record.action) != move.piece.rotation;
+                labels++;
+            }
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+            game.play_moves();
+        }
+    }
+    std::cout << "labels inside the masks: " << labels - outside << "/" << labels << " (" << twins << " moved onto their twin)" << std::endl;
+}
+
+// records self play games, then re-simulates them through the checker and against playing the same moves from memory
+void replay_check_bench() {
+    constexpr int games = 2000;
+    constexpr u32 keyframe_interval = 16;
+    constexpr int corrupted = 7;
+
+    DropPolicy policy;
+    std::vector<std::string> paths;
+    std::vector<std::vector<std::pair<Move, Move>>> moves(games);
+    u64 recorded_turns = 0;
+    double recorded_atk = 0;
+    for (int g = 0; g < games; ++g) {
+        const u32 seed = (u32)hash_mix((u64)g + 777);
+        VersusGame game(seed);
+        RNG rng(seed);
+        paths.push_back("replay_check_bench_" + std::to_string(g) + ".shkr");
+
+        ReplayWriter writer;
+        if (!writer.open(paths.back().c_str(), game, seed, seed, keyframe_interval)) {
+            std::cout << "could not write " << paths.back() << std::endl;
+            return;
+        }
+        game.recorder = &writer;
+        while (!game.game_over) {
+            const Move p1 = policy(game, 0, rng);
+            const Move p2 = policy(game, 1, rng);
+            if (p1.null_move || p2.null_move)
+                break;
+            moves[g].emplace_back(p1, p2);
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+            game.play_moves();
+        }
+        writer.close();
+        recorded_turns += game.turn;
+        recorded_atk += game.p1_atk;
+    }
+
+    // the baseline, the same moves played straight from memory on one thread
+    auto time_start = std::chrono::steady_clock::now();
+    u64 raw_check = 0;
+    for (int g = 0; g < games; ++g) {
+        const u32 seed = (u32)hash_mix((u64)g + 777);
+        VersusGame game(seed);
+        for (const auto& [p1, p2] : moves[g]) {
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+            game.play_moves();
+        }
+        raw_check += game.p1_game.hash();
+    }
+    const double raw_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count();
+
+    ThreadPool pool;
+    std::vector<ReplayCheckResult> results(paths.size());
+    const ReplayCheckStats clean = check_replays(pool, paths, results);
+    bool ok = clean.diverged == 0 && clean.unreadable == 0 && clean.turns == recorded_turns && clean.attack[0] == recorded_atk;
+
+    ThreadPool single(1);
+    const ReplayCheckStats sequential = check_replays(single, paths, results);
+    ok &= sequential.turns == clean.turns;
+
+    // one stored hash changed, the checker has to stop right there
+    const u64 bad_turn = moves[corrupted].size() / 2;
+    {
+        std::FILE* file = std::fopen(paths[corrupted].c_str(), "r+b");
+        const long offset = (long)(sizeof(ReplayHeader) + (bad_turn / keyframe_interval) * (keyframe_interval * sizeof(ReplayTurn) + sizeof(ReplayKeyframe<RNG>)) +
+            (bad_turn % keyframe_interval) * sizeof(ReplayTurn) + offsetof(ReplayTurn, check));
+        u16 check = 0;
+        std::fseek(file, offset, SEEK_SET);
+        std::fread(&check, sizeof(check), 1, file);
+        check ^= 1;
+        std::fseek(file, offset, SEEK_SET);
+        std::fwrite(&check, sizeof(check), 1, file);
+        std::fclose(file);
+    }
+    const ReplayCheckStats broken = check_replays(pool, paths, results);
+    ok &= broken.diverged == 1 && results[corrupted].divergence == (std::int64_t)bad_turn;
+
+    for (const std::string& path : paths)
+        std::remove(path.c_str());
+
+    // drops barely clear a line, so a few games where both players take the placement sending the most attack and keeping b2b,
+    // the flattest board breaking ties, have to come back with the app and max b2b they were played with
+    auto attacker = [](const VersusGame& game, int id, RNG&) {
+        const Game& player = game.get_game(id);
+        Move best;
+        float best_score = -std::numeric_limits<float>::infinity();
+        for (const Piece& piece : player.get_possible_piece_placements()) {
+            Game after = player;
+            after.place_piece(piece);
+            const int lines = after.board.clearLines();
+            const int attack = after.damage_sent(lines, piece.spin, after.board.is_empty());
+            const float score = 100.0f * (float)attack + 300.0f * (float)after.b2b + Shaktris::Search::evaluate(after.board);
+            if (score > best_score) {
+                best = Move(piece, false);
+                best_score = score;
+            }
+        }
+        return best;
+    };
+    std::vector<std::string> attack_paths;
+    double attack_p1 = 0;
+    u16 attack_b2b = 0;
+    u64 attack_turns = 0;
+    for (int g = 0; g < 4; ++g) {
+        const u32 seed = (u32)hash_mix((u64)g + 999);
+        VersusGame game(seed);
+        RNG rng(seed);
+        attack_paths.push_back("replay_check_bench_attack_" + std::to_string(g) + ".shkr");
+        ReplayWriter writer;
+        if (!writer.open(attack_paths.back().c_str(), game, seed, seed, keyframe_interval)) {
+            std::cout << "could not write " << attack_paths.back() << std::endl;
+            return;
+        }
+        game.recorder = &writer;
+        while (!game.game_over && game.turn < 200) {
+            const Move p1 = attacker(game, 0, rng);
+            const Move p2 = attacker(game, 1, rng);
+            if (p1.null_move || p2.null_move)
+                break;
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+            game.play_moves();
+            attack_b2b = std::max<u16>(attack_b2b, game.p1_game.b2b);
+        }
+        writer.close();
+        attack_p1 += game.p1_atk;
+        attack_turns += game.turn;
+    }
+    std::vector<ReplayCheckResult> attack_results(attack_paths.size());
+    const ReplayCheckStats attacking = check_replays(pool, attack_paths, attack_results);
+    const bool attack_ok = attack_p1 > 0 && attack_b2b > 0 && attacking.diverged == 0 && attacking.turns == attack_turns &&
+                           attacking.attack[0] == attack_p1 && attacking.app(0) == attack_p1 / (double)attack_turns && attacking.max_b2b[0] == attack_b2b;
+    for (const std::string& path : attack_paths)
+        std::remove(path.c_str());
+
+    std::cout << "games: " << games << "\tturns: " << clean.turns << "\tapp p1: " << clean.app(0) << "\tmax b2b p1: " << clean.max_b2b[0]
+              << "\twins p1 " << clean.p1_wins << " p2 " << clean.p2_wins << " draws " << clean.draws << std::endl;
+    std::cout << "raw simulation: " << recorded_turns / raw_s / 1e6 << "M turns/s on 1 thread" << std::endl;
+    std::cout << "replay check:   " << clean.turns_per_second() / 1e6 << "M turns/s on " << pool.size() << " threads, "
+              << sequential.turns_per_second() / 1e6 << "M turns/s on 1" << std::endl;
+    std::cout << "clean replays pass and the corrupted one diverges at its turn: " << (ok ? "yes" : "NO") << std::endl;
+    std::cout << "attacking games: turns " << attacking.turns << "\tapp p1: " << attacking.app(0) << "\tmax b2b p1: " << attacking.max_b2b[0]
+              << "\tmatch what was played: " << (attack_ok ? "yes" : "NO") << std::endl;
+}
+
+// every placement of every piece on boards from self play, checked one at a time against the full movegen
+void reach_bench() {
+    using namespace Shaktris::MoveGen;
+
+    // positions from drop policy games, plus the overhang board so the search path gets exercised
+    std::vector<Board> boards;
+    DropPolicy policy;
+    for (u32 seed = 1; boards.size() < 400; ++seed) {
+        VersusGame game(seed);
+        RNG rng(seed);
+        while (!game.game_over && boards.size() < 400) {
+            boards.push_back(game.p1_game.board);
+            const Move p1 = policy(game, 0, rng);
+            const Move p2 = policy(game, 1, rng);
+            if (p1.null_move || p2.null_move)
+                break;
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+            game.play_moves();
+        }
+    }
+    Board tall;
+    tall.board = { 0b111111111100, 0b110000001100, 0b110000001100, 0b110011001100, 0b110011001100,
+        0b110011001100, 0b110011001100, 0b110011001100, 0b000011000000, 0b000011111111 };
+    boards.push_back(tall);
+
+    bool matches = true;
+    std::size_t legal = 0;
+    std::size_t checked = 0;
+    std::int64_t movegen_ns = 0;
+    std::int64_t check_ns = 0;
+    for (const Board& board : boards) {
+        for (std::size_t t = 0; t < (std::size_t)PieceType::Empty; ++t) {
+            const PieceType type = (PieceType)t;
+            std::vector<Placement> moves;
+            auto time_start = std::chrono::steady_clock::now();
+            Smeared::god_movegen(board, type, moves);
+            auto time_mid = std::chrono::steady_clock::now();
+            // god_movegen does not check the spawn itself, a spawn overlapping the board is not a placement
+            std::erase_if(moves, [&](Placement placement) { return Shaktris::Utility::collides(board, placement.to_piece()); });
+            for (Placement placement : moves)
+                matches &= Reachability::is_legal(board, placement);
+            auto time_stop = std::chrono::steady_clock::now();
+            movegen_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(time_mid - time_start).count();
+            check_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(time_stop - time_mid).count();
+            legal += moves.size();
+
+            // and everything else is rejected, north and east twins standing in for south and west
+            std::array<std::array<std::array<spinType, Board::height>, Board::width>, RotationDirections_N> given;
+            for (auto& rotation : given)
+                for (auto& column : rotation)
+                    column.fill((spinType)3);
+            for (Placement placement : moves)
+                given[placement.rotation()][(std::size_t)placement.position().x][(std::size_t)placement.position().y] = placement.spin();
+            for (std::size_t rot = 0; rot < RotationDirections_N; ++rot) {
+                for (std::size_t x = 0; x < Board::width; ++x) {
+                    for (std::size_t y = 0; y < Board::height; ++y) {
+                        const Smeared::SmearedPiece canonical =
+                            Smeared::cannonicalize({ Coord((i8)x, (i8)y), (u8)rot }, type);
+                        std::optional<spinType> expected;
+                        if (canonical.position.x >= 0 && canonical.position.x < (i8)Board::width && canonical.position.y >= 0 &&
+                            canonical.position.y < (i8)Board::height &&
+                            given[canonical.rot][(std::size_t)canonical.position.x][(std::size_t)canonical.position.y] != (spinType)3)
+                            expected = given[canonical.rot][(std::size_t)canonical.position.x][(std::size_t)canonical.position.y];
+                        matches &= Reachability::reachable_spin(board, Placement(type, (RotationDirection)rot, Coord((i8)x, (i8)y))) == expected;
+                        checked++;
+                    }
+                }
+            }
+        }
+    }
+
+    // one move per game, a batch of boards with a legal and a faked spin each
+    std::vector<Placement> batch;
+    std::vector<u8> out(boards.size() * 2);
+    std::vector<Board> batch_boards;
+    for (const Board& board : boards) {
+        std::vector<Placement> moves;
+        Smeared::god_movegen(board, PieceType::T, moves);
+        const Placement move = moves[moves.size() / 2];
+        batch.push_back(move);
+        batch.push_back(Placement(move.type(), move.rotation(), move.position(), move.spin() == spinType::null ? spinType::normal : spinType::null));
+        batch_boards.push_back(board);
+        batch_boards.push_back(board);
+    }
+    Reachability::is_legal(batch_boards, batch, out);
+    for (std::size_t i = 0; i < out.size(); ++i)
+        matches &= out[i] == (i % 2 == 0);
+
+    std::cout << "boards: " << boards.size() << "\tplacements checked: " << checked << std::endl;
+    std::cout << "full movegen: " << movegen_ns / (std::int64_t)(boards.size() * 7) << " ns per piece\tone legal placement: "
+              << check_ns / (std::int64_t)legal << " ns" << std::endl;
+    std::cout << "matches god_movegen everywhere: " << (matches ? "yes" : "NO") << std::endl;
+}
+
+// a path to every placement full movegen gives, played back through the game and checked against a plain bfs for length
+void path_bench() {
+    using namespace Shaktris::MoveGen;
+
+    std::vector<Board> boards;
+    DropPolicy policy;
+    for (u32 seed = 1; boards.size() < 200; ++seed) {
+        VersusGame game(seed);
+        RNG rng(seed);
+        while (!game.game_over && boards.size() < 200) {
+            boards.push_back(game.p1_game.board);
+            const Move p1 = policy(game, 0, rng);
+            const Move p2 = policy(game, 1, rng);
+            if (p1.null_move || p2.null_move)
+                break;
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+            game.play_moves();
+        }
+    }
+    Board tall;
+    tall.board = { 0b111111111100, 0b110000001100, 0b110000001100, 0b110011001100, 0b110011001100,
+        0b110011001100, 0b110011001100, 0b110011001100, 0b000011000000, 0b000011111111 };
+    boards.push_back(tall);
+
+    constexpr std::array<Movement, 5> movements = { Movement::Left, Movement::Right, Movement::RotateClockwise,
+        Movement::RotateCounterClockwise, Movement::SonicDrop };
+    auto cells = [](const Piece& piece) {
+        std::array<int, 4> out;
+        for (std::size_t i = 0; i < 4; ++i)
+            out[i] = (piece.minos[i].x + piece.position.x) * 64 + piece.minos[i].y + piece.position.y;
+        std::ranges::sort(out);
+        return out;
+    };
+
+    PathSearch::Search search;
+    Game game;
+    bool matches = true;
+    std::size_t searched = 0;
+    std::size_t paths = 0;
+    std::size_t unreachable = 0;
+    std::size_t spins = 0;
+    std::size_t inputs = 0;
+    std::int64_t movegen_ns = 0;
+    std::int64_t search_ns = 0;
+    std::vector<Movement> path;
+    for (const Board& board : boards) {
+        game.board = board;
+        for (std::size_t t = 0; t < (std::size_t)PieceType::Empty; ++t) {
+            const PieceType type = (PieceType)t;
+            // nothing gets out of a spawn overlapping the board
+            if (Shaktris::Utility::collides(board, Piece(type)))
+                continue;
+            std::vector<Placement> moves;
+            auto time_start = std::chrono::steady_clock::now();
+            Smeared::god_movegen(board, type, moves);
+            movegen_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_start).count();
+            std::erase_if(moves, [&](Placement placement) { return Shaktris::Utility::collides(board, placement.to_piece()); });
+
+            // fewest inputs to every cell set, from a bfs over the game's own moves
+            std::vector<std::pair<std::array<int, 4>, int>> shortest;
+            {
+                std::array<std::array<std::array<bool, Board::height>, 16>, RotationDirections_N> seen{};
+                std::vector<Piece> open = { Piece(type) };
+                seen[0][4 + 3][piece_spawn_height] = true;
+                for (int distance = 0; !open.empty(); ++distance) {
+                    std::vector<Piece> next;
+                    for (const Piece& piece : open) {
+                        shortest.emplace_back(cells(piece), distance);
+                        for (Movement movement : movements) {
+                            Piece moved = piece;
+                            game.process_movement(moved, movement);
+                            bool& visited = seen[moved.rotation][(std::size_t)(moved.position.x + 3)][(std::size_t)moved.position.y];
+                            if (!visited) {
+                                visited = true;
+                                next.push_back(moved);
+                            }
+                        }
+                    }
+                    open = std::move(next);
+                }
+            }
+
+            for (const Placement placement : moves) {
+                const Piece target = placement.to_piece();
+                path.clear();
+                auto search_start = std::chrono::steady_clock::now();
+                const bool found = search.find(board, target, path);
+                search_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - search_start).count();
+                searched++;
+
+                int fewest = -1;
+                for (const auto& [reached, distance] : shortest) {
+                    if (reached == cells(target) && (fewest < 0 || distance < fewest))
+                        fewest = distance;
+                }
+                // god_movegen drops pieces from the sky on convex boards, above a high stack that is somewhere spawn never gets to
+                if (!found) {
+                    matches &= fewest < 0;
+                    unreachable++;
+                    continue;
+                }
+                paths++;
+                inputs += path.size();
+
+                Piece piece(type);
+                for (Movement movement : path)
+                    game.process_movement(piece, movement);
+                matches &= cells(piece) == cells(target);
+                if (target.spin != spinType::null && type != PieceType::O) {
+                    spins++;
+                    matches &= !path.empty() && (path.back() == Movement::RotateClockwise || path.back() == Movement::RotateCounterClockwise);
+                    continue;
+                }
+                matches &= fewest == (int)path.size();
+            }
+        }
+    }
+
+    std::cout << "boards: " << boards.size() << "\tpaths: " << paths << " (" << spins << " ending in a spin, " << unreachable
+              << " not reachable from spawn)\tinputs per path: " << (double)inputs / paths << std::endl;
+    std::cout << "full movegen: " << movegen_ns / (std::int64_t)(boards.size() * 7) << " ns per piece\tone path: "
+              << search_ns / (std::int64_t)searched << " ns" << std::endl;
+    std::cout << "every path plays out to its placement with the fewest inputs: " << (matches ? "yes" : "NO") << std::endl;
+}
+
+// hard drop placements on self play boards, checked against doing the same turns, shifts and drops on pieces
+void harddrop_bench() {
+    using namespace Shaktris::MoveGen;
+
+    std::vector<Board> boards;
+    DropPolicy policy;
+    for (u32 seed = 1; boards.size() < 1000; ++seed) {
+        VersusGame game(seed);
+        RNG rng(seed);
+        while (!game.game_over && boards.size() < 1000) {
+            boards.push_back(game.p1_game.board);
+            const Move p1 = policy(game, 0, rng);
+            const Move p2 = policy(game, 1, rng);
+            if (p1.null_move || p2.null_move)
+                break;
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+            game.play_moves();
+        }
+    }
+    // a well under a roof at spawn height and a tower next to spawn
+    Board roof;
+    roof.board = { 0, 0, 0b11 << 20, 0b11 << 20, 0, 0, 0, (1u << 22) - 1, 0, 0 };
+    boards.push_back(roof);
+
+    auto cells = [](const Piece& piece) {
+        std::array<int, 4> out;
+        for (std::size_t i = 0; i < 4; ++i)
+            out[i] = (piece.minos[i].x + piece.position.x) * 64 + piece.minos[i].y + piece.position.y;
+        std::ranges::sort(out);
+        return out;
+    };
+
+    // turned at spawn, slid as far as it goes each way and dropped
+    auto reference = [&](const Board& board, PieceType type) {
+        std::vector<std::array<int, 4>> ret;
+        if (Shaktris::Utility::collides(board, Piece(type)))
+            return ret;
+        const std::vector<std::vector<TurnDirection>> turns = type == PieceType::O
+            ? std::vector<std::vector<TurnDirection>>{ {} }
+            : std::vector<std::vector<TurnDirection>>{ {}, { TurnDirection::Right }, { TurnDirection::Right, TurnDirection::Right }, { TurnDirection::Left } };
+        for (const auto& sequence : turns) {
+            Piece piece(type);
+            bool turned = true;
+            for (TurnDirection dir : sequence) {
+                const RotationDirection before = piece.rotation;
+                srs_rotate(board, piece, dir);
+                turned &= piece.rotation != before;
+            }
+            if (!turned)
+                continue;
+            for (int dir : { -1, 1 }) {
+                Piece slid = piece;
+                while (true) {
+                    Piece dropped = slid;
+                    Shaktris::Utility::sonic_drop(board, dropped);
+                    ret.push_back(cells(dropped));
+                    const i8 x = slid.position.x;
+                    Shaktris::Utility::shift(board, slid, dir);
+                    if (slid.position.x == x)
+                        break;
+                }
+            }
+        }
+        std::ranges::sort(ret);
+        ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
+        return ret;
+    };
+
+    bool matches = true;
+    std::size_t placements = 0;
+    std::int64_t reference_ns = 0;
+    for (const Board& board : boards) {
+        for (std::size_t t = 0; t < (std::size_t)PieceType::Empty; ++t) {
+            const PieceType type = (PieceType)t;
+            auto time_start = std::chrono::steady_clock::now();
+            const std::vector<std::array<int, 4>> expected = reference(board, type);
+            reference_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_start).count();
+
+            std::vector<std::array<int, 4>> given;
+            for (const Piece& piece : HardDrop::movegen(board, type)) {
+                matches &= piece.spin == spinType::null;
+                given.push_back(cells(piece));
+            }
+            std::ranges::sort(given);
+            matches &= given == expected;
+            placements += given.size();
+
+            const Smeared::SmearedBoard s_board = Smeared::smear(board, type);
+            const HardDrop::Starts starts = HardDrop::starts(s_board, type);
+#ifdef __AVX2__
+            matches &= HardDrop::landings_avx2(s_board, starts) == HardDrop::landings_scalar(s_board, starts);
+#endif
+        }
+    }
+
+    // timed separately, the loops above are mostly the reference
+    constexpr int rounds = 200;
+    std::vector<Smeared::SmearedBoard> smeared;
+    for (const Board& board : boards)
+        for (std::size_t t = 0; t < (std::size_t)PieceType::Empty; ++t)
+            smeared.push_back(Smeared::smear(board, (PieceType)t));
+    std::size_t checksum = 0;
+    auto time_start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const Board& board : boards) {
+            for (std::size_t t = 0; t < (std::size_t)PieceType::Empty; ++t) {
+                const Smeared::SmearedBoard moves = HardDrop::moves(board, (PieceType)t);
+                checksum += moves.boards[0].board[4] + moves.boards[1].board[3];
+            }
+        }
+    }
+    auto time_full = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < smeared.size(); ++i) {
+            const Smeared::SmearedBoard moves = HardDrop::landings_scalar(smeared[i], HardDrop::starts(smeared[i], (PieceType)(i % 7)));
+            checksum += moves.boards[0].board[4] + moves.boards[1].board[3];
+        }
+    }
+    auto time_scalar = std::chrono::steady_clock::now();
+#ifdef __AVX2__
+    for (int round = 0; round < rounds; ++round) {
+        for (std::size_t i = 0; i < smeared.size(); ++i) {
+            const Smeared::SmearedBoard moves = HardDrop::landings_avx2(smeared[i], HardDrop::starts(smeared[i], (PieceType)(i % 7)));
+            checksum += moves.boards[0].board[4] + moves.boards[1].board[3];
+        }
+    }
+#endif
+    auto time_avx2 = std::chrono::steady_clock::now();
+    std::int64_t god_ns = 0;
+    {
+        std::vector<Placement> out;
+        auto god_start = std::chrono::steady_clock::now();
+        for (const Board& board : boards) {
+            for (std::size_t t = 0; t < (std::size_t)PieceType::Empty; ++t) {
+                out.clear();
+                Smeared::god_movegen(board, (PieceType)t, out);
+                checksum += out.size();
+            }
+        }
+        god_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - god_start).count();
+    }
+
+    const double calls = (double)smeared.size() * rounds;
+    auto per_call = [&](auto a, auto b) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count() / calls;
+    };
+    std::cout << "boards: " << boards.size() << "\tplacements: " << placements << "\tchecksum: " << checksum << std::endl;
+    std::cout << "hard drop movegen: " << per_call(time_start, time_full) << " ns per piece, smear included" << std::endl;
+    std::cout << "from a smeared board: scalar " << per_call(time_full, time_scalar) << " ns";
+#ifdef __AVX2__
+    std::cout << "\tavx2 " << per_call(time_scalar, time_avx2) << " ns";
+#endif
+    std::cout << std::endl;
+    std::cout << "reference: " << reference_ns / (std::int64_t)smeared.size() << " ns\tgod_movegen: " << god_ns / (std::int64_t)smeared.size() << " ns" << std::endl;
+    std::cout << "matches turning, shifting and dropping pieces: " << (matches ? "yes" : "NO") << std::endl;
+}
+
+// the three engines with 180 rotations on, against each other and against themselves without
+void rotate180_bench() {
+    using namespace Shaktris::MoveGen;
+
+    std::vector<Board> boards;
+    DropPolicy policy;
+    for (u32 seed = 1; boards.size() < 300; ++seed) {
+        VersusGame game(seed);
+        RNG rng(seed);
+        while (!game.game_over && boards.size() < 300) {
+            boards.push_back(game.p1_game.board);
+            const Move p1 = policy(game, 0, rng);
+            const Move p2 = policy(game, 1, rng);
+            if (p1.null_move || p2.null_move)
+                break;
+            game.set_move(0, p1);
+            game.set_move(1, p2);
+            game.play_moves();
+        }
+    }
+    Board tall;
+    tall.board = { 0b111111111100, 0b110000001100, 0b110000001100, 0b110011001100, 0b110011001100,
+        0b110011001100, 0b110011001100, 0b110011001100, 0b000011000000, 0b000011111111 };
+    boards.push_back(tall);
+
+    using Cells = std::array<int, 4>;
+    auto cells = [](const Piece& piece) {
+        Cells out;
+        for (std::size_t i = 0; i < 4; ++i)
+            out[i] = (piece.minos[i].x + piece.position.x) * 64 + piece.minos[i].y + piece.position.y;
+        std::ranges::sort(out);
+        return out;
+    };
+    auto cell_set = [&](const std::vector<Piece>& pieces) {
+        std::vector<Cells> out;
+        for (const Piece& piece : pieces)
+            out.push_back(cells(piece));
+        std::ranges::sort(out);
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return out;
+    };
+
+    std::array<std::int64_t, 6> ns{};
+    auto timed = [&](std::size_t slot, auto&& f) {
+        auto time_start = std::chrono::steady_clock::now();
+        auto ret = f();
+        ns[slot] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_start).count();
+        return ret;
+    };
+
+    bool matches = true;
+    bool superset = true;
+    std::size_t differing = 0;
+    std::size_t flood_gains = 0;
+    std::size_t flood_agrees = 0;
+    std::size_t gained_boards = 0;
+    std::size_t gained = 0;
+    std::size_t pieces = 0;
+    std::size_t mode_checked = 0;
+    std::size_t mode_mismatches = 0;
+    for (const Board& board : boards) {
+        for (std::size_t t = 0; t < (std::size_t)PieceType::Empty; ++t) {
+            const PieceType type = (PieceType)t;
+            if (Shaktris::Utility::collides(board, Piece(type)))
+                continue;
+            pieces++;
+
+            const auto god = cell_set(timed(0, [&] { return Smeared::god_movegen(board, type); }));
+            const auto god_180 = cell_set(timed(1, [&] { return Smeared::god_movegen<&tetrio_180_kicks>(board, type); }));
+            const auto traditional = cell_set(timed(2, [&] { return Traditional::movegen(srs_rotate, board, type); }));
+            const auto traditional_180 = cell_set(timed(3, [&] { return Traditional::movegen(srs_rotate, board, type, &tetrio_180_kicks); }));
+            const auto flood = cell_set(timed(4, [&] { return Smeared::movegen(board, type); }));
+            const auto flood_180 = cell_set(timed(5, [&] { return Smeared::movegen<&tetrio_180_kicks>(board, type); }));
+
+            // the two exact engines agree wherever they already did without 180s
+            if (god == traditional)
+                matches &= god_180 == traditional_180;
+            else
+                differing++;
+            superset &= std::ranges::includes(god_180, god) && std::ranges::includes(traditional_180, traditional) && std::ranges::includes(flood_180, flood);
+            if (god_180.size() > god.size()) {
+                gained_boards++;
+                gained += god_180.size() - god.size();
+            }
+            // the flood fill is looser than the other two, what 180s add to it should still be what they add to god_movegen
+            std::vector<Cells> flood_gained;
+            std::ranges::set_difference(flood_180, flood, std::back_inserter(flood_gained));
+            for (const Cells& placement : flood_gained)
+                flood_agrees += std::ranges::binary_search(god_180, placement) && !std::ranges::binary_search(god, placement);
+            flood_gains += flood_gained.size();
+
+            // a game generates, masks and checks placements with its mode's kicks, 180s under tetr.io and none under botris
+            for (const GameModes& mode : { GameModes(TetrioS1()), GameModes(Botris()) }) {
+                Game game;
+                game.mode = mode;
+                game.board = board;
+                game.current_piece = Piece(type);
+                game.hold = type;
+                std::vector<Placement> expected;
+                if (std::holds_alternative<TetrioS1>(mode))
+                    Smeared::god_movegen<&tetrio_180_kicks>(board, type, expected);
+                else
+                    Smeared::god_movegen(board, type, expected);
+                std::vector<Placement> given;
+                game.get_possible_placements(given);
+                const Shaktris::ActionMask::Masks masks = Shaktris::ActionMask::masks(game);
+                bool same = given == expected && game.get_possible_piece_placements().size() == expected.size() && masks.count() == expected.size();
+                for (Placement placement : expected) {
+                    const std::size_t action = masks.action(placement);
+                    same &= masks.legal(action) && masks.placement(action) == placement && VecEnv<>::legal(game, placement) == placement;
+                }
+                mode_checked++;
+                mode_mismatches += !same;
+            }
+        }
+    }
+
+    // the game's own movement, a T sitting on a bump turns over by kicking up one with tetr.io's kicks
+    // and stays put under botris, which has no 180s
+    Game game;
+    game.board.board = { 0, 0, 0, 1, 1, 1, 0, 0, 0, 0 };
+    auto turned = [&](const GameModes& mode) {
+        game.mode = mode;
+        Piece t(PieceType::T);
+        for (Movement movement : { Movement::SonicDrop, Movement::Rotate180 })
+            game.process_movement(t, movement);
+        return t;
+    };
+    const Piece tetrio_t = turned(TetrioS1());
+    const Piece botris_t = turned(Botris());
+    const bool kicked = tetrio_t.rotation == RotationDirection::South && tetrio_t.position.x == 4 && tetrio_t.position.y == 2 &&
+                        botris_t.rotation == RotationDirection::North;
+
+    auto per_piece = [&](std::size_t slot) {
+        return ns[slot] / (std::int64_t)pieces;
+    };
+    auto slower = [&](std::size_t with, std::size_t without) {
+        return 100.0 * (double)(ns[with] - ns[without]) / (double)ns[without];
+    };
+    std::cout << "boards: " << boards.size() << "\tpieces: " << pieces << "\tpieces with more placements: " << gained_boards << " (+" << gained << ")" << std::endl;
+    std::cout << "god_movegen: " << per_piece(0) << " ns\twith 180: " << per_piece(1) << " ns (" << slower(1, 0) << "%)" << std::endl;
+    std::cout << "traditional: " << per_piece(2) << " ns\twith 180: " << per_piece(3) << " ns (" << slower(3, 2) << "%)" << std::endl;
+    std::cout << "flood fill:  " << per_piece(4) << " ns\twith 180: " << per_piece(5) << " ns (" << slower(5, 4) << "%)" << std::endl;
+    std::cout << "flood fill placements from 180s: " << flood_gains << ", " << flood_agrees << " of them also new in god_movegen" << std::endl;
+    std::cout << "god_movegen and traditional agree with 180 on: " << (matches ? "yes" : "NO") << " (" << differing << " pieces differ without)"
+              << "\tnothing lost: " << (superset ? "yes" : "NO") << "\tgame kicks the 180 by its mode: " << (kicked ? "yes" : "NO") << std::endl;
+    std::cout << "game placements, masks and legality follow the mode's kicks: " << (mode_mismatches == 0 ? "yes" : "NO") << " (" << mode_mismatches << "/"
+              << mode_checked << " differ)" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    const std::string_view bench = argc > 1 ? argv[1] : "";
+
+    if (bench == "tt") {
+        tt_bench();
+        return 0;
+    }
+
+    if (bench == "search") {
+        search_bench();
+        return 0;
+    }
+
+    if (bench == "tbp") {
+        tbp_bench();
+        return 0;
+    }
+
+    if (bench == "batch") {
+        batch_bench();
+        return 0;
+    }
+
+    if (bench == "make") {
+        make_bench();
+        return 0;
+    }
+
+    if (bench == "rng") {
+        rng_bench();
+        return 0;
+    }
+
+    if (bench == "sample") {
+        sample_bench();
+        return 0;
+    }
+
+    if (bench == "placement") {
+        placement_bench();
+        return 0;
+    }
+
+    if (bench == "attack") {
+        attack_bench();
+        return 0;
+    }
+
+    if (bench == "selfplay") {
+        selfplay_bench();
+        return 0;
+    }
+
+    if (bench == "env") {
+        env_bench();
+        return 0;
+    }
+
+    if (bench == "mask") {
+        mask_bench();
+        return 0;
+    }
+
+    if (bench == "replay") {
+        replay_bench();
+        return 0;
+    }
+
+    if (bench == "reach") {
+        reach_bench();
+        return 0;
+    }
+
+    if (bench == "path") {
+        path_bench();
+        return 0;
+    }
+
+    if (bench == "harddrop") {
+        harddrop_bench();
+        return 0;
+    }
+
+    if (bench == "rotate180") {
+        rotate180_bench();
+        return 0;
+    }
+
+    if (bench == "replaycheck") {
+        replay_check_bench();
+        return 0;
+    }
+
+    if (bench == "datagen") {
+        datagen_bench();
+        return 0;
+    }
+
+    if (bench == "pool") {
+        pool_bench();
+        return 0;
+    }
+
     Citrus();
     return 0;
 
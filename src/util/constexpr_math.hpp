@@ -0,0 +1,56 @@
+#pragma once
+
+// std::log1p is not constexpr (yet), this one is good to about an ulp of double
+// so rounding it to float matches the float overload of std::log1p
+constexpr double constexpr_log1p(double x) {
+    constexpr double ln2 = 0.693147180559945309417232121458176568;
+    constexpr double sqrt2 = 1.41421356237309504880168872420969808;
+
+    if (x == 0.0)
+        return x;
+
+    // small x would lose everything to the 1 + x below
+    if (x > -0.25 && x < 0.25) {
+        double term = x;
+        double sum = 0.0;
+        for (int n = 1; n < 64; ++n) {
+            const double next = sum + (n & 1 ? term : -term) / n;
+            if (next == sum)
+                break;
+            sum = next;
+            term *= x;
+        }
+        return sum;
+    }
+
+    // 1 + x = m * 2^k with m in [sqrt(1/2), sqrt(2))
+    double m = 1.0 + x;
+    int k = 0;
+    while (m >= sqrt2) {
+        m *= 0.5;
+        k++;
+    }
+    while (m < sqrt2 * 0.5) {
+        m *= 2.0;
+        k--;
+    }
+
+    // ln(m) = 2 atanh(s), with s = (m - 1) / (m + 1) and |s| < 0.172
+    const double s = (m - 1.0) / (m + 1.0);
+    const double s2 = s * s;
+    double term = s;
+    double sum = 0.0;
+    for (int n = 1; n < 64; n += 2) {
+        const double next = sum + term / n;
+        if (next == sum)
+            break;
+        sum = next;
+        term *= s2;
+    }
+
+    return k * ln2 + 2.0 * sum;
+}
+
+constexpr float constexpr_log1p(float x) {
+    return static_cast<float>(constexpr_log1p(static_cast<double>(x)));
+}
@@ -1,3 +1,5 @@
+#pragma once
+
 #include <climits>
 #include <concepts>
 #include <cstdint>
@@ -61,3 +63,42 @@ constexpr T pext(const T src, const T mask) {
 
 #endif
 }
+
+// inverse of pext, scatters the low bits of src into the set bits of mask
+template <std::integral T>
+constexpr T pdep_impl(const T SRC, const T MASK) {
+    T DEST = 0;
+    int k = 0;
+    for (int m = 0; m < int(sizeof(T) * CHAR_BIT); ++m) {
+        if ((MASK >> m) & 1) {
+            DEST |= ((SRC >> k) & 1) << m;
+            k = k + 1;
+        }
+    }
+
+    return DEST;
+}
+
+template <std::integral T>
+constexpr T pdep(const T src, const T mask) {
+    if (std::is_constant_evaluated()) {
+        return pdep_impl(src, mask);
+    }
+
+#if defined(SHAK_PEXTABLE)
+    if constexpr (std::same_as<T, std::uint64_t>) {
+        return _pdep_u64(src, mask);
+    }
+    else if constexpr (std::same_as<T, std::uint32_t>) {
+        return _pdep_u32(src, mask);
+    }
+    else {
+        return pdep_impl(src, mask);
+    }
+
+#else
+
+    return pdep_impl(src, mask);
+
+#endif
+}
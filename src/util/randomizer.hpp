@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <random>
+#include <span>
+#include <utility>
+
+#include "engine/ShaktrisConstants.hpp"
+#include "rng.hpp"
+
+// what VersusGame and Game need out of a piece randomizer, everything is resolved at compile time
+// getRand also picks garbage columns, fill_bags deals a whole buffer of pieces in one call
+template <class R>
+concept randomizer = requires(R rng, u32 upper_bound, std::span<PieceType> out) {
+    { rng.getPiece() } -> std::same_as<PieceType>;
+    { rng.getRand(upper_bound) } -> std::convertible_to<u32>;
+    rng.fill_bags(out);
+};
+
+// TETR.IO's seeded 7 bag
+using Bag7 = RNG;
+
+static_assert(randomizer<RNG>);
+static_assert(randomizer<CounterRNG>);
+
+// two of every piece shuffled together
+class Bag14 {
+   public:
+    Bag14() : Bag14(std::random_device()()) {}
+    explicit Bag14(u64 seed) : rng(seed) {
+        makebag();
+    }
+
+    PieceType getPiece() {
+        if (bagiterator == bag.size()) {
+            makebag();
+        }
+        return bag[bagiterator++];
+    }
+
+    u32 getRand(u32 upperBound) {
+        return rng.getRand(upperBound);
+    }
+
+    void makebag() {
+        bagiterator = 0;
+        deal(bag.data(), rng.key, rng.counter);
+        rng.counter += bag.size();
+    }
+
+    // same pieces as that many getPiece calls, whole bags only depend on their own counters
+    void fill_bags(std::span<PieceType> out) {
+        size_t i = 0;
+        while (i < out.size() && bagiterator < bag.size())
+            out[i++] = bag[bagiterator++];
+
+        const size_t bags = (out.size() - i) / bag.size();
+        for (size_t b = 0; b < bags; ++b)
+            deal(&out[i + b * bag.size()], rng.key, rng.counter + b * bag.size());
+        rng.counter += bags * bag.size();
+        i += bags * bag.size();
+
+        if (i < out.size()) {
+            makebag();
+            while (i < out.size())
+                out[i++] = bag[bagiterator++];
+        }
+    }
+
+    CounterRNG rng;
+    std::array<PieceType, 14> bag;
+    uint8_t bagiterator;
+
+   private:
+    static void deal(PieceType* out, u64 key, u64 counter) {
+        for (size_t i = 0; i < 14; ++i)
+            out[i] = static_cast<PieceType>(i % 7);
+        for (int i = 13; i > 0; --i) {
+            const u32 j = CounterRNG::draw(key, counter + (u64)i, (u32)i + 1);
+            std::swap(out[i], out[j]);
+        }
+    }
+};
+
+// every piece is independent of the ones before it
+class PureRandom {
+   public:
+    PureRandom() : PureRandom(std::random_device()()) {}
+    explicit PureRandom(u64 seed) : rng(seed) {}
+
+    PieceType getPiece() {
+        return static_cast<PieceType>(rng.getRand(7));
+    }
+
+    u32 getRand(u32 upperBound) {
+        return rng.getRand(upperBound);
+    }
+
+    // no dependency between iterations, so this is just a wide loop over the counter
+    void fill_bags(std::span<PieceType> out) {
+        const u64 key = rng.key;
+        const u64 counter = rng.counter;
+        for (size_t i = 0; i < out.size(); ++i)
+            out[i] = static_cast<PieceType>(CounterRNG::draw(key, counter + i, 7));
+        rng.counter += out.size();
+    }
+
+    CounterRNG rng;
+};
+
+// the NES randomizer, roll one of eight, and if that is the last piece or the eighth reroll once out of seven
+class NesReroll {
+   public:
+    NesReroll() : NesReroll(std::random_device()()) {}
+    explicit NesReroll(u64 seed) : rng(seed) {}
+
+    PieceType getPiece() {
+        const u64 n = rng.counter;
+        rng.counter += 2;
+        return previous = pick(previous, rng.key, n);
+    }
+
+    u32 getRand(u32 upperBound) {
+        return rng.getRand(upperBound);
+    }
+
+    // both rolls of every piece come straight from the counter, only the reroll check walks in order
+    void fill_bags(std::span<PieceType> out) {
+        const u64 key = rng.key;
+        const u64 counter = rng.counter;
+        for (size_t i = 0; i < out.size(); ++i)
+            out[i] = previous = pick(previous, key, counter + 2 * i);
+        rng.counter += 2 * out.size();
+    }
+
+    CounterRNG rng;
+    PieceType previous = PieceType::Empty;
+
+   private:
+    static PieceType pick(PieceType previous, u64 key, u64 n) {
+        const u32 roll = CounterRNG::draw(key, n, 8);
+        const u32 reroll = CounterRNG::draw(key, n + 1, 7);
+        return roll == 7 || static_cast<PieceType>(roll) == previous ? static_cast<PieceType>(reroll) : static_cast<PieceType>(roll);
+    }
+};
+
+static_assert(randomizer<Bag14>);
+static_assert(randomizer<PureRandom>);
+static_assert(randomizer<NesReroll>);
@@ -18,24 +18,83 @@ u32 RNG::getRand(u32 upperBound) {
 
 void RNG::makebag() {
     bagiterator = 0;
-    u32 buffer = 0;
-
-    std::array<PieceType, 7> pieces = {
-        PieceType::S,
-        PieceType::Z,
-        PieceType::J,
-        PieceType::L,
-        PieceType::T,
-        PieceType::O,
-        PieceType::I};
-
-    for (int_fast8_t i = 6; i >= 0; i--) {
-        buffer = getRand(i + 1);
-        bag[i] = pieces[buffer];
-        std::swap(pieces[buffer], pieces[i]);
-    }
+    deal_bag(bag.data(), [&](u32 n) { return getRand(n); });
 }
 
 void RNG::new_seed() {
     PPTRNG = std::random_device()();
-}
\ No newline at end of file
+}
+
+void RNG::seed(u32 seed) {
+    PPTRNG = seed;
+    makebag();
+}
+
+RNG RNG::split() {
+    getRand(0);
+    return RNG(static_cast<u32>(hash_mix(PPTRNG)));
+}
+
+void RNG::fill_bags(std::span<PieceType> out) {
+    size_t i = 0;
+    while (i < out.size() && bagiterator < 7)
+        out[i++] = bag[bagiterator++];
+
+    // whole bags go straight into out with the state kept in a register
+    u32 state = PPTRNG;
+    auto draw = [&](u32 n) {
+        state = state * 0x5d588b65 + 0x269ec3;
+        return ((state >> 0x10) * n) >> 0x10;
+    };
+    for (; out.size() - i >= 7; i += 7)
+        deal_bag(&out[i], draw);
+    PPTRNG = state;
+
+    if (i < out.size()) {
+        makebag();
+        while (i < out.size())
+            out[i++] = bag[bagiterator++];
+    }
+}
+
+PieceType CounterRNG::getPiece() {
+    if (bagiterator == 7) {
+        makebag();
+    }
+    return bag[bagiterator++];
+}
+
+u32 CounterRNG::getRand(u32 upperBound) {
+    return draw(key, counter++, upperBound);
+}
+
+void CounterRNG::makebag() {
+    bagiterator = 0;
+    deal_bag(bag.data(), [&](u32 n) { return getRand(n); });
+}
+
+CounterRNG CounterRNG::split() {
+    return CounterRNG(hash_mix(key ^ hash_mix(counter++ | (u64(1) << 63))));
+}
+
+void CounterRNG::fill_bags(std::span<PieceType> out) {
+    size_t i = 0;
+    while (i < out.size() && bagiterator < 7)
+        out[i++] = bag[bagiterator++];
+
+    // every bag only depends on its own seven counters, so the bags do not wait on each other
+    const size_t bags = (out.size() - i) / 7;
+    for (size_t b = 0; b < bags; ++b) {
+        const u64 base = counter + b * 7;
+        u64 n = 0;
+        deal_bag(&out[i + b * 7], [&](u32 upper) { return draw(key, base + n++, upper); });
+    }
+    counter += bags * 7;
+    i += bags * 7;
+
+    if (i < out.size()) {
+        makebag();
+        while (i < out.size())
+            out[i++] = bag[bagiterator++];
+    }
+}
@@ -3,14 +3,38 @@
 #include <algorithm>
 #include <array>
 #include <random>
+#include <span>
 #include <utility>
 
 #include "engine/ShaktrisConstants.hpp"
+#include "hash.hpp"
 
+// one 7 bag shuffled the way TETR.IO does it, draw(n) has to return a number in [0, n)
+template <class Draw>
+inline void deal_bag(PieceType* bag, Draw&& draw) {
+    std::array<PieceType, 7> pieces = {
+        PieceType::S,
+        PieceType::Z,
+        PieceType::J,
+        PieceType::L,
+        PieceType::T,
+        PieceType::O,
+        PieceType::I};
+
+    for (int_fast8_t i = 6; i >= 0; i--) {
+        const u32 buffer = draw(i + 1);
+        bag[i] = pieces[buffer];
+        std::swap(pieces[buffer], pieces[i]);
+    }
+}
+
+// TETR.IO's generator, the same seed gives the same pieces as the game does
 class RNG {
    public:
-    RNG() {
-        PPTRNG = std::random_device()();
+    // std::random_device is a syscall, anything that makes a lot of these should pass a seed
+    RNG() : RNG(std::random_device()()) {}
+    explicit RNG(u32 seed) {
+        PPTRNG = seed;
         makebag();
     }
     u32 PPTRNG;
@@ -22,4 +46,45 @@ class RNG {
 
     void makebag();
     void new_seed();
-};
\ No newline at end of file
+    void seed(u32 seed);
+
+    // a new generator seeded off of this one, for handing to another worker
+    // both are still the same 32 bit lcg further along, use CounterRNG when the streams have to be independent
+    RNG split();
+
+    // the next out.size() pieces, the same ones that many getPiece calls would give
+    void fill_bags(std::span<PieceType> out);
+};
+
+// counter based generator, the n-th number is a pure function of the key and n (splitmix64)
+// so streams split off with different keys never overlap and any bag can be dealt without the ones before it
+class CounterRNG {
+   public:
+    explicit CounterRNG(u64 key) : key(key) {
+        makebag();
+    }
+    u64 key;
+    u64 counter = 0;
+    std::array<PieceType, 7> bag;
+    uint8_t bagiterator;
+
+    PieceType getPiece();
+    u32 getRand(u32 upperBound);
+
+    void makebag();
+
+    // independent stream for another worker, deterministic given this one's key and counter
+    CounterRNG split();
+
+    // the next out.size() pieces, the same ones that many getPiece calls would give
+    void fill_bags(std::span<PieceType> out);
+
+    // the n-th getRand of the stream with this key, inline so bulk loops over it can vectorize
+    static u32 draw(u64 key, u64 n, u32 upperBound) {
+        const u32 r = static_cast<u32>(hash_mix(key + (n + 1) * 0x9e3779b97f4a7c15ULL) >> 32);
+        if (upperBound != 0) {
+            return static_cast<u32>((u64(r) * upperBound) >> 32);
+        }
+        return r >> 0x10;
+    }
+};
@@ -0,0 +1,173 @@
+#include "threadpool.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace {
+    // which pool the current thread belongs to and at what index
+    thread_local const ThreadPool* current_pool = nullptr;
+    thread_local std::size_t current_index = 0;
+
+    void pin_to_cpu(std::thread& thread, std::size_t cpu) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#elif defined(_WIN32)
+        SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << cpu);
+#else
+        (void)thread;
+        (void)cpu;
+#endif
+    }
+}
+
+ThreadPool::ThreadPool(std::size_t threads, bool pin_threads) {
+    threads = std::max<std::size_t>(threads, 1);
+    queues = std::make_unique<Queue[]>(threads + 1);
+
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([this, i] { worker_loop(i); });
+    }
+
+    if (pin_threads) {
+        const std::size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+        for (std::size_t i = 0; i < threads; ++i) {
+            pin_to_cpu(workers[i], i % cpus);
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(sleep_lock);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+int ThreadPool::worker_index() const {
+    return current_pool == this ? static_cast<int>(current_index) : -1;
+}
+
+void ThreadPool::push(const Task& task) {
+    const int index = worker_index();
+    Queue& queue = queues[index >= 0 ? static_cast<std::size_t>(index) : workers.size()];
+
+    bool full;
+    {
+        std::lock_guard lock(queue.lock);
+        full = queue.tail - queue.head == queue_capacity;
+        if (!full)
+            queue.tasks[queue.tail++ % queue_capacity] = task;
+    }
+    // only very wide fan outs fill a queue, there are plenty of queued tasks for everyone else then
+    if (full) {
+        execute(task);
+        return;
+    }
+    queued.fetch_add(1);
+
+    if (sleepers.load() != 0) {
+        { std::lock_guard lock(sleep_lock); }
+        wake.notify_one();
+    }
+}
+
+bool ThreadPool::pop(std::size_t index, Task& out) {
+    Queue& queue = queues[index];
+    std::lock_guard lock(queue.lock);
+    if (queue.tail == queue.head)
+        return false;
+
+    out = queue.tasks[--queue.tail % queue_capacity];
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool ThreadPool::steal(std::size_t thief, Task& out) {
+    const std::size_t n = workers.size() + 1;
+    for (std::size_t i = 1; i <= n; ++i) {
+        Queue& queue = queues[(thief + i) % n];
+        if (!queue.lock.try_lock())
+            continue;
+
+        bool found = false;
+        if (queue.tail != queue.head) {
+            out = queue.tasks[queue.head++ % queue_capacity];
+            queued.fetch_sub(1, std::memory_order_relaxed);
+            found = true;
+        }
+        queue.lock.unlock();
+
+        if (found)
+            return true;
+    }
+    return false;
+}
+
+// the exception goes to the group that queued the task, nothing escapes into a worker
+void ThreadPool::execute(const Task& task) {
+    std::exception_ptr thrown;
+    try {
+        task.fn(task.arg);
+    }
+    catch (...) {
+        thrown = std::current_exception();
+    }
+    if (task.group)
+        task.group->finish(std::move(thrown));
+}
+
+bool ThreadPool::try_run_one() {
+    const int index = worker_index();
+    const std::size_t self = index >= 0 ? static_cast<std::size_t>(index) : workers.size();
+
+    Task task;
+    if (pop(self, task) || steal(self, task)) {
+        execute(task);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(std::size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    constexpr int spins_before_sleep = 64;
+    int idle = 0;
+
+    while (true) {
+        Task task;
+        if (pop(index, task) || steal(index, task)) {
+            execute(task);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < spins_before_sleep) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock lock(sleep_lock);
+        sleepers.fetch_add(1);
+        wake.wait(lock, [this] { return stopping || queued.load() != 0; });
+        sleepers.fetch_sub(1);
+
+        if (stopping && queued.load() == 0)
+            return;
+        idle = 0;
+    }
+}
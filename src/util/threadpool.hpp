@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class TaskGroup;
+
+// work stealing thread pool
+// every worker owns a queue, it pushes and pops at the back (so recursive work stays hot in cache)
+// while idle workers steal the oldest tasks from the front of someone else's queue
+// work goes in through a TaskGroup, which is also where a task's exception ends up
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threads = std::max(1u, std::thread::hardware_concurrency()), bool pin_threads = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const {
+        return workers.size();
+    }
+
+    // index of the calling thread inside this pool, -1 if it is not one of our workers
+    int worker_index() const;
+
+    // runs a single queued task on the calling thread, returns false if there was nothing to run
+    bool try_run_one();
+
+    // per thread scratch storage, e.g. reusable movegen buffers
+    // lives as long as the thread does and is never shared
+    template <class T>
+    static T& scratch() {
+        thread_local T value{};
+        return value;
+    }
+
+private:
+    friend class TaskGroup;
+
+    // a unit of work, just a function pointer and its argument so queueing never allocates
+    struct Task {
+        void (*fn)(void*) = nullptr;
+        void* arg = nullptr;
+        TaskGroup* group = nullptr;
+    };
+
+    // fixed ring of tasks, a push to a full queue runs the task right away instead of growing it
+    static constexpr std::size_t queue_capacity = 1024;
+
+    struct alignas(64) Queue {
+        std::mutex lock;
+        std::size_t head = 0;  // oldest task, where thieves take from
+        std::size_t tail = 0;  // one past the newest, where the owner pushes and pops
+        std::array<Task, queue_capacity> tasks;
+    };
+
+    void push(const Task& task);
+    void worker_loop(std::size_t index);
+    bool pop(std::size_t index, Task& out);
+    bool steal(std::size_t thief, Task& out);
+    static void execute(const Task& task);
+
+    std::vector<std::thread> workers;
+    // one queue per worker, the last one takes pushes from threads outside the pool
+    std::unique_ptr<Queue[]> queues;
+
+    std::atomic<std::size_t> queued = 0;
+    std::atomic<std::size_t> sleepers = 0;
+    std::atomic<bool> stopping = false;
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+};
+
+// fork/join scope, every task run through it is finished once wait() returns
+// the waiting thread helps out with queued work instead of blocking, so groups can nest freely
+// if a task throws, the first exception is rethrown from wait(), the other tasks still run to the end
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    // waits without rethrowing, a destructor can not throw, call wait() to see the exception
+    ~TaskGroup() {
+        join();
+    }
+
+    // f is taken by reference and has to outlive wait()
+    template <class F>
+    void run(F& f) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        pool.push(ThreadPool::Task{ [](void* arg) { (*static_cast<F*>(arg))(); }, &f, this });
+    }
+
+    void wait() {
+        join();
+        if (error) {
+            std::exception_ptr thrown = std::exchange(error, nullptr);
+            failed.store(false, std::memory_order_relaxed);
+            std::rethrow_exception(thrown);
+        }
+    }
+
+private:
+    friend class ThreadPool;
+
+    void join() {
+        while (pending.load(std::memory_order_acquire) != 0) {
+            if (!pool.try_run_one())
+                std::this_thread::yield();
+        }
+    }
+
+    // called by the pool once per task, the error is written before pending drops so join sees it
+    void finish(std::exception_ptr thrown) {
+        if (thrown && !failed.exchange(true, std::memory_order_relaxed))
+            error = std::move(thrown);
+        pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    ThreadPool& pool;
+    std::atomic<std::size_t> pending = 0;
+    std::atomic<bool> failed = false;
+    std::exception_ptr error;
+};
+
+// runs a on the pool and b on the calling thread, returns once both are done
+template <class A, class B>
+void fork_join(ThreadPool& pool, A&& a, B&& b) {
+    TaskGroup group(pool);
+    group.run(a);
+    b();
+    group.wait();
+}
+
+// calls f(i) for every i in [begin, end), splitting the range in halves until it is at most grain long
+template <class F>
+void parallel_for(ThreadPool& pool, std::size_t begin, std::size_t end, std::size_t grain, const F& f) {
+    if (end - begin <= std::max<std::size_t>(grain, 1)) {
+        for (std::size_t i = begin; i < end; ++i)
+            f(i);
+        return;
+    }
+
+    const std::size_t mid = begin + (end - begin) / 2;
+    fork_join(pool,
+        [&] { parallel_for(pool, begin, mid, grain, f); },
+        [&] { parallel_for(pool, mid, end, grain, f); });
+}